@@ -4,6 +4,7 @@
 #if CONFIG_WRAPPER_ESP32_BOARD_LILYGO_T_LORA_PAGER
 
 #include <functional>
+#include <memory>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "driver/gpio.h"
@@ -19,6 +20,7 @@
 #include "wrapper/display.hpp"
 #include "wrapper/audio.hpp"
 #include "wrapper/lvgl.hpp"
+#include "wrapper/init-graph.hpp"
 #include "device/xl9555.hpp"
 #include "device/st7796.hpp"
 #include "device/tca8418.hpp"
@@ -188,11 +190,15 @@ I2sChanStdConfig i2s_chan_cfg(
 // XL9555 设备配置
 I2cDeviceConfig xl9555_dev_cfg(Xl9555::DEFAULT_ADDR, Xl9555::DEFAULT_SPEED);
 
-// BQ25896 设备配置
-I2cDeviceConfig bq25896_dev_cfg(Bq25896::DEFAULT_ADDR, Bq25896::DEFAULT_SPEED);
+// BQ25896 设备配置 (充电管理, 低优先级)
+I2cDeviceConfig bq25896_dev_cfg(Bq25896::DEFAULT_ADDR,
+                                Bq25896::DEFAULT_SPEED,
+                                I2cPriority::Background);
 
-// TCA8418 设备配置
-I2cDeviceConfig tca8418_dev_cfg(Tca8418::DEFAULT_ADDR, Tca8418::DEFAULT_SPEED);
+// TCA8418 设备配置 (键盘, 交互优先)
+I2cDeviceConfig tca8418_dev_cfg(Tca8418::DEFAULT_ADDR,
+                                Tca8418::DEFAULT_SPEED,
+                                I2cPriority::Interactive);
 
 // LVGL 移植层
 LvglPortConfig lvgl_port_cfg(5,                                    // task_priority
@@ -218,7 +224,7 @@ LvglDisplayConfig lvgl_display_cfg(480 * 60,                // 缓冲区大小
                                    true,                    // buff_dma
                                    true,                    // buff_spiram
                                    false,                   // sw_rotate
-                                   true,                    // swap_bytes（SPI 大端序）
+                                   false,                   // swap_bytes（由面板代理交换）
                                    false,                   // full_refresh
                                    false                    // direct_mode
 );
@@ -254,6 +260,7 @@ Logger l_pmu("LoraPager", "I2C", "BQ25896");
 Logger l_enc("LoraPager", "Encoder");
 Logger l_kbdrv("LoraPager", "Keyboard");
 Logger l_sd("LoraPager", "SPI", "SD");
+Logger l_boot("LoraPager", "Boot");
 
 // =============================================================================
 // 设备 / 总线实例（文件作用域，只构造一次）
@@ -273,6 +280,8 @@ Encoder encoder;  // 旋转编码器（A=GPIO40, B=GPIO41, 按钮=GPIO7）
 // 高层键盘驱动（封装 TCA8418，含模式解码）
 LilyGoLoRaPagerKeyboard keyboard_driver(l_kbdrv, tca8418);
 SdSpi sd_spi(l_sd);  // SD 卡（SPI 模式，CS=GPIO21）
+// 共享 SPI 总线仲裁：显示屏按 20 行分片刷新，SD / 射频事务在片间插入
+SpiArbiter spi_arbiter(l_spi);
 
 // =============================================================================
 // ES8311 编解码器工厂 lambda
@@ -354,7 +363,7 @@ bool LilyGoLoraPager::InitCoreBusAndIoExpander()
         l_i2c.Error("I2C bus init failed");
         return false;
     }
-    i2c_bus.Scan();
+    i2c_bus.Detect();
 
     // 2. XL9555 IO 扩展器
     //    默认 Init() 将所有输出引脚拉高，从而使能所有外设。
@@ -381,7 +390,34 @@ bool LilyGoLoraPager::InitCoreBusAndIoExpander()
     return true;
 }
 
-bool LilyGoLoraPager::InitDisplay()
+bool LilyGoLoraPager::Init()
+{
+    // 核心总线与 XL9555 之后, 显示 (含约 160 ms 面板等待)、音频、键盘在两个核心上并行;
+    // SD 与编码器在显示之后 (共享 SPI 总线 / LVGL). 音频与 SD 都读-改-写 XL9555 输出寄存器,
+    // SD 同时依赖音频, 两者不并发
+    auto graph = std::make_unique<InitGraph>(l_boot);
+    int core = graph->AddStage("core", [this]
+                               { return InitBootButton() && InitCoreBusAndIoExpander(); });
+    int display_stage = graph->AddStage("display", [this] { return InitDisplay(); }, {core});
+    int audio = graph->AddStage("audio", [this] { return InitAudio(); }, {core});
+    graph->AddStage("keyboard", [this] { return InitKeyboard(); }, {core});
+    graph->AddStage("encoder", [this] { return InitEncoder(); }, {display_stage});
+    // SD 卡可能未插入, 不影响启动结果
+    graph->AddStage(
+        "sd", [this] { return InitSdCard(); }, {display_stage, audio}, InitGraph::kAnyCore,
+        true);
+
+    bool ok = graph->Run(5, 6144);
+    graph->PrintTimeline();
+    PanelInitTiming panel = display.GetInitTiming();
+    l_boot.Info("ST7796 init %lld ms, %lld ms blocked", panel.elapsed_us / 1000,
+                panel.blocked_us / 1000);
+    return ok;
+}
+
+bool LilyGoLoraPager::InitDisplay() { return StartDisplay() && FinishDisplay(); }
+
+bool LilyGoLoraPager::StartDisplay()
 {
     // 1. 共享 SPI 总线
     if (!spi_bus.Init(spi_bus_cfg))
@@ -408,7 +444,19 @@ bool LilyGoLoraPager::InitDisplay()
     //    xl9555.SetLevel(kXl9555PinDispRst, 1);
     //    vTaskDelay(pdMS_TO_TICKS(10));
 
-    // 4. LEDC 背光（初始关闭）
+    // 4. ST7796 显示面板：发出复位后立即返回，后续步骤由 ContinueInit/FinishInit 推进
+    if (!display.BeginInit(spi_bus, spi_display_cfg))
+    {
+        l_disp.Error("ST7796 display init failed");
+        return false;
+    }
+    return true;
+}
+
+bool LilyGoLoraPager::FinishDisplay()
+{
+    // 5. LEDC 背光（初始关闭）与 LVGL 移植层不依赖面板，在 ST7796 的等待窗口内完成，
+    //    每项之后推进已到期的面板步骤
     if (!ledc_timer.Init(ledc_timer_cfg))
     {
         l_ledc.Error("LEDC timer init failed");
@@ -419,9 +467,19 @@ bool LilyGoLoraPager::InitDisplay()
         l_ledc.Error("LEDC channel init failed");
         return false;
     }
+    if (!display.ContinueInit())
+    {
+        l_disp.Error("ST7796 display init failed");
+        return false;
+    }
+    if (!lvgl_port.Init(lvgl_port_cfg))
+    {
+        l_lvgl.Error("LVGL port init failed");
+        return false;
+    }
 
-    // 5. ST7796 显示面板
-    if (!display.Init(spi_bus, spi_display_cfg))
+    // 6. 等待 ST7796 剩余的初始化步骤
+    if (!display.FinishInit())
     {
         l_disp.Error("ST7796 display init failed");
         return false;
@@ -430,19 +488,25 @@ bool LilyGoLoraPager::InitDisplay()
     // 行偏移 = 49（可视区域从控制器第 49 行开始）。
     display.SetGap(0, 49);
 
-    // 6. LVGL 移植层
-    if (!lvgl_port.Init(lvgl_port_cfg))
+    // 每片 480 × 20 行（约 3.8 ms @ 40 MHz）；与 SD 同优先级、3:1 带宽权重。
+    // LoRa / NFC 驱动接入时以 priority 0 注册，保证射频 FIFO 的时延。
+    int display_client = spi_arbiter.AddClient("display", 1, 3);
+    display.EnableSlicing(480 * 20 * sizeof(uint16_t), &spi_arbiter, display_client);
+    // SPI 大端序：代理按行带交换到 DMA 暂存区，LVGL 不再交换
+    if (!display.EnableByteSwap(480 * 20 * sizeof(uint16_t)))
     {
-        l_lvgl.Error("LVGL port init failed");
+        l_disp.Error("ST7796 byte swap setup failed");
         return false;
     }
+
+    // 7. 将面板注册到 LVGL
     if (!lvgl_port.AddDisplay(display, lvgl_display_cfg))
     {
         l_lvgl.Error("LVGL AddDisplay failed");
         return false;
     }
 
-    // 7. 以最大亮度打开背光
+    // 8. 以最大亮度打开背光
     SetDisplayBrightness(100);
 
     return true;
@@ -532,6 +596,7 @@ bool LilyGoLoraPager::InitSdCard()
     vTaskDelay(pdMS_TO_TICKS(10));  // 等待电源稳定
 
     // 2. 在共享 SPI 总线上挂载 SD 卡（CS=GPIO21），VFS 路径 /sdcard
+    sd_spi.SetArbiter(spi_arbiter, spi_arbiter.AddClient("sd", 1, 1));
     if (!sd_spi.Init(spi_bus, sd_spi_dev_cfg, sd_spi_mount_cfg, "/sdcard"))
     {
         l_sd.Error("SD card mount failed");
@@ -554,6 +619,7 @@ bool LilyGoLoraPager::InitSdCard()
 
 I2cBus& LilyGoLoraPager::GetI2cBus() { return i2c_bus; }
 SpiBus& LilyGoLoraPager::GetSpiBus() { return spi_bus; }
+SpiArbiter& LilyGoLoraPager::GetSpiArbiter() { return spi_arbiter; }
 I2sBus& LilyGoLoraPager::GetI2sBus() { return i2s_bus; }
 Xl9555& LilyGoLoraPager::GetIoExpander() { return xl9555; }
 St7796& LilyGoLoraPager::GetDisplay() { return display; }
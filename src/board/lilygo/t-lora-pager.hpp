@@ -38,6 +38,7 @@ namespace wrapper
  * 用法：
  * @code
  *   auto& board = wrapper::LilyGoLoraPager::GetInstance();
+ *   board.Init();  // 或按需逐项调用：
  *   board.InitCoreBusAndIoExpander();
  *   board.InitDisplay();
  *   board.GetLvglPort().SetRotation(LV_DISPLAY_ROTATION_0);
@@ -57,6 +58,11 @@ class LilyGoLoraPager
     LilyGoLoraPager(LilyGoLoraPager&&) = delete;
     LilyGoLoraPager& operator=(LilyGoLoraPager&&) = delete;
 
+    // InitDisplay 的两半：SPI 总线 + 面板复位 / 背光与 LVGL 移植层（与面板等待重叠）+
+    // 剩余面板步骤 + 注册显示
+    bool StartDisplay();
+    bool FinishDisplay();
+
    public:
     static LilyGoLoraPager& GetInstance()
     {
@@ -70,6 +76,15 @@ class LilyGoLoraPager
     // 初始化 — 按顺序调用
     // -----------------------------------------------------------------------
 
+    /**
+     * @brief 按依赖图初始化全部外设，并打印各阶段时间线。
+     *
+     * 核心总线之后，显示、音频、键盘在两个核心上并行，音频与键盘落在
+     * ST7796 复位/唤醒约 160 ms 的等待内；编码器与 SD 卡在显示之后。
+     * SD 卡挂载失败不影响返回值。
+     */
+    bool Init();
+
     bool InitBootButton();  // GPIO0 低电平触发软件关机
 
     /** @brief 初始化 I²C 总线 + XL9555 IO 扩展器 + BQ25896 充电器 */
@@ -117,6 +132,7 @@ class LilyGoLoraPager
 
     I2cBus& GetI2cBus();
     SpiBus& GetSpiBus();
+    SpiArbiter& GetSpiArbiter();
     I2sBus& GetI2sBus();
     Xl9555& GetIoExpander();
     St7796& GetDisplay();
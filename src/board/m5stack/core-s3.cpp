@@ -1,3 +1,4 @@
+#include <memory>
 #include <tuple>
 
 #include "esp_lcd_ili9341.h"
@@ -12,6 +13,7 @@
 #include "wrapper/touch.hpp"
 #include "wrapper/lvgl.hpp"
 #include "wrapper/audio.hpp"
+#include "wrapper/init-graph.hpp"
 
 #include "device/axp2101.hpp"
 #include "device/aw9523.hpp"
@@ -180,7 +182,7 @@ LvglDisplayConfig lvgl_display_config(320 * 240,               // buffer_size
                                       true,                    // buff_dma
                                       true,                    // buff_spiram
                                       false,                   // sw_rotate
-                                      true,                    // swap_bytes
+                                      false,                   // swap_bytes (面板代理交换)
                                       false,                   // full_refresh
                                       false                    // direct_mode
 );
@@ -197,6 +199,7 @@ Logger logger_ft5x06("M5StackCoreS3", "I2C", "Touch");
 Logger logger_ili9341("M5StackCoreS3", "SPI", "Display");
 Logger logger_lvgl("M5StackCoreS3", "LVGL", "Port");
 Logger logger_audio_codec("M5StackCoreS3", "Audio", "Codec");
+Logger logger_boot("M5StackCoreS3", "Boot");
 
 I2cBus i2c_bus1(logger_i2c_bus1);
 SpiBus spi_bus(logger_spi_bus);
@@ -301,6 +304,9 @@ bool M5StackCoreS3::InitDevice(bool power, bool audio, bool display, bool touch)
 {
     if (power)
     {
+        // 事务约 1 KB, 静态持有并在两颗芯片间复用, 不占初始化工作任务的栈
+        static I2cTransaction txn;
+
         // AXP2101
         if (!axp2101.Init(i2c_bus1, axp2101_config))
             return false;
@@ -319,11 +325,13 @@ bool M5StackCoreS3::InitDevice(bool power, bool audio, bool display, bool touch)
             {0x94, 33 - 5},
             {0x95, 33 - 5},
         };
+        txn.Clear();
         for (const auto& [reg, value] : axp_cmds)
         {
-            if (!axp2101.WriteReg8(reg, value, -1))
-                return false;
+            txn.WriteReg8(reg, value);
         }
+        if (!axp2101.Execute(txn, -1))
+            return false;
         axp2101.GetLogger().Info("Configured successfully");
 
         // AW9523
@@ -334,13 +342,15 @@ bool M5StackCoreS3::InitDevice(bool power, bool audio, bool display, bool touch)
             {0x02, 0b00000111}, {0x03, 0b10001111}, {0x04, 0b00011000}, {0x05, 0b00001100},
             {0x11, 0b00010000}, {0x12, 0b11111111}, {0x13, 0b11111111},
         };
+        txn.Clear();
         for (const auto& [reg, value] : aw_cmds)
         {
-            if (!aw9523.WriteReg8(reg, value, -1))
-            {
-                aw9523.GetLogger().Error("Failed to write register 0x%02X", reg);
-                return false;
-            }
+            txn.WriteReg8(reg, value);
+        }
+        if (!aw9523.Execute(txn, -1))
+        {
+            aw9523.GetLogger().Error("Failed to write init registers");
+            return false;
         }
         aw9523.GetLogger().Info("Configured successfully");
     }
@@ -358,6 +368,8 @@ bool M5StackCoreS3::InitDevice(bool power, bool audio, bool display, bool touch)
             ili9341.GetLogger().Error("Failed to initialize display");
             return false;
         }
+        if (!ili9341.EnableByteSwap(320 * 20 * sizeof(uint16_t)))
+            return false;
     }
 
     if (audio)
@@ -406,11 +418,32 @@ bool M5StackCoreS3::Init()
 {
     if (initialized_)
         return true;
-    if (!InitBus(true, true, true))
-        return false;
-    if (!InitDevice(true, true, true, true))
-        return false;
-    if (!InitMiddleware(true))
+
+    // 电源 (AXP2101/AW9523) 之后显示、触摸、音频互不依赖, 与 LVGL 初始化一起分布到两个核心
+    auto graph = std::make_unique<InitGraph>(logger_boot);
+    int i2c = graph->AddStage("i2c", [this] { return InitBus(true, false, false); });
+    int spi = graph->AddStage("spi", [this] { return InitBus(false, true, false); });
+    int i2s = graph->AddStage("i2s", [this] { return InitBus(false, false, true); });
+    int power = graph->AddStage(
+        "power", [this] { return InitDevice(true, false, false, false); }, {i2c});
+    int display = graph->AddStage(
+        "display", [this] { return InitDevice(false, false, true, false); }, {spi, power});
+    int touch = graph->AddStage(
+        "touch", [this] { return InitDevice(false, false, false, true); }, {power});
+    graph->AddStage(
+        "audio", [this] { return InitDevice(false, true, false, false); }, {i2s, power});
+    int lvgl = graph->AddStage("lvgl", [] { return lvgl_port.Init(lvgl_port_config); });
+    int lvgl_display = graph->AddStage(
+        "lvgl_display", [] { return lvgl_port.AddDisplay(ili9341, lvgl_display_config); },
+        {lvgl, display});
+    graph->AddStage(
+        "lvgl_touch", [] { return lvgl_port.AddTouch(ft5x06, lvgl_touch_config); },
+        {lvgl_display, touch});
+
+    // 阶段内有驱动、LVGL 与日志调用, 工作任务栈用 6 KB
+    bool ok = graph->Run(5, 6144);
+    graph->PrintTimeline();
+    if (!ok)
         return false;
 
     initialized_ = true;
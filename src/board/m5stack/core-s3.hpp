@@ -37,6 +37,7 @@ class M5StackCoreS3
     bool InitBus(bool i2c, bool spi, bool i2s);
     bool InitDevice(bool power, bool audio, bool display, bool touch);
     bool InitMiddleware(bool lvgl);
+    // 全部初始化; 各阶段按依赖图在两个核心上并行, 结束后打印时间线
     bool Init();
 
     I2cBus& GetI2cBus1();
@@ -1,10 +1,12 @@
 #include <esp_lcd_ili9881c.h>
 #include <esp_lcd_touch_gt911.h>
+#include <memory>
 #include <string>
 #include "board/m5stack/tab5.hpp"
 #include "device/ili9881c.hpp"
 #include "device/gt911.hpp"
 #include "device/m5stack_tab5_keyboard.hpp"
+#include "wrapper/init-graph.hpp"
 
 namespace wrapper
 {
@@ -198,6 +200,7 @@ Logger laudio("Board", "Audio");
 Logger llvgl("Board", "LVGL");
 Logger li2c1("Board", "I2C1", "Bus");
 Logger lkb("Board", "I2C1", "Keyboard");
+Logger lboot("Board", "Boot");
 
 // ── 总线实例 ──
 I2cBus i2c0_bus(li2c0);
@@ -282,6 +285,22 @@ std::function<esp_err_t()> mic_codec_new_func = []() -> esp_err_t
     return ESP_OK;
 };
 
+bool M5StackTab5::Init()
+{
+    // 显示 (含 100 ms DSI PHY 上电等待) 与音频都只依赖 IO 扩展器, 键盘在独立的 I2C1 上
+    auto graph = std::make_unique<InitGraph>(lboot);
+    int core = graph->AddStage("core", [this] { return InitCoreBusAndIoExpander(); });
+    graph->AddStage("display", [this] { return InitDisplay(); }, {core});
+    graph->AddStage("audio", [this] { return InitAudio(); }, {core});
+    // 键盘为可选配件, 未连接时不影响启动结果
+    graph->AddStage(
+        "keyboard", [this] { return InitKeyboard(); }, {}, InitGraph::kAnyCore, true);
+
+    bool ok = graph->Run(5, 6144);
+    graph->PrintTimeline();
+    return ok;
+}
+
 bool M5StackTab5::InitCoreBusAndIoExpander()
 {
     // I2C0 Bus
@@ -289,7 +308,7 @@ bool M5StackTab5::InitCoreBusAndIoExpander()
     {
         return false;
     }
-    i2c0_bus.Scan();
+    i2c0_bus.Detect();
 
     // IO Expanders (Pi4ioe5v6408 尚未完成重构，Init 返回 esp_err_t)
     if (!io_expander0.Init(i2c0_bus, Pi4ioe5v6408::ADDR_LOW))  // 0x43
@@ -307,19 +326,22 @@ bool M5StackTab5::InitCoreBusAndIoExpander()
     io_expander1.SetDirection(IO_EXPANDER_PIN_NUM_0, IO_EXPANDER_OUTPUT);  // WIFI_EN
     io_expander1.SetLevel(IO_EXPANDER_PIN_NUM_0, 1);
 
-    return true;
-}
-
-bool M5StackTab5::InitDisplay()
-{
-    // IO Expander0: LCD 和触摸相关引脚
+    // IO Expander0: LCD、触摸与扬声器电源. 方向/电平寄存器为读-改-写, 在这里集中设置,
+    // 避免并行的显示与音频阶段互相覆盖对方的位
     io_expander0.SetDirection(IO_EXPANDER_PIN_NUM_4, IO_EXPANDER_OUTPUT);  // LCD_EN
     io_expander0.SetLevel(IO_EXPANDER_PIN_NUM_4, 1);
     io_expander0.SetOutputMode(IO_EXPANDER_PIN_NUM_4, IO_EXPANDER_OUTPUT_MODE_PUSH_PULL);
-
     io_expander0.SetDirection(IO_EXPANDER_PIN_NUM_5, IO_EXPANDER_OUTPUT);  // TOUCH_EN
     io_expander0.SetLevel(IO_EXPANDER_PIN_NUM_5, 1);
+    io_expander0.SetDirection(IO_EXPANDER_PIN_NUM_1, IO_EXPANDER_OUTPUT);  // SPEAKER_EN
+    io_expander0.SetLevel(IO_EXPANDER_PIN_NUM_1, 1);
 
+    return true;
+}
+
+bool M5StackTab5::InitDisplay()
+{
+    // LCD_EN/TOUCH_EN 已在 InitCoreBusAndIoExpander 中使能
     // Backlight (LEDC)
     if (!ledc_timer.Init(ledc_timer_cfg))
     {
@@ -377,10 +399,7 @@ bool M5StackTab5::InitDisplay()
 
 bool M5StackTab5::InitAudio()
 {
-    // IO Expander0: 扬声器上电
-    io_expander0.SetDirection(IO_EXPANDER_PIN_NUM_1, IO_EXPANDER_OUTPUT);  // SPEAKER_EN
-    io_expander0.SetLevel(IO_EXPANDER_PIN_NUM_1, 1);
-
+    // SPEAKER_EN 已在 InitCoreBusAndIoExpander 中使能
     // I2S 总线
     if (!i2s_bus.Init(i2s_bus_cfg))
     {
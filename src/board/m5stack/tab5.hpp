@@ -33,9 +33,10 @@ class M5StackTab5
         return instance;
     }
 
-    bool InitCoreBusAndIoExpander();  ///< I2C0 总线 + IO Expander 实例化
-    bool InitDisplay();               ///< LCD_EN/TOUCH_EN 引脚 + 背光 + DSI + 触摸 + LVGL
-    bool InitAudio();                 ///< SPEAKER_EN 引脚 + I2S 总线 + AudioCodec
+    bool Init();                      ///< 以下各项按依赖图并行初始化, 并打印时间线
+    bool InitCoreBusAndIoExpander();  ///< I2C0 总线 + IO Expander + 全部扩展器电源引脚
+    bool InitDisplay();               ///< 背光 + DSI + 触摸 + LVGL
+    bool InitAudio();                 ///< I2S 总线 + AudioCodec
     bool InitKeyboard();              ///< 键盘 I2C1 总线 + 驱动
 
     I2cBus& GetI2cBus();
@@ -3,7 +3,13 @@
 namespace wrapper
 {
 
-Aw9523::Aw9523(Logger& logger) : I2cDevice(logger) {}
+Aw9523::Aw9523(Logger& logger) : I2cDevice(logger)
+{
+    // 0x00-0x01 输入与 0x7F 软复位不缓存; 输出/方向/中断/LED 配置寄存器只由主机改写
+    CacheRegisters(0x02, 0x07);
+    CacheRegisters(0x11, 0x13);
+    CacheRegisters(0x20, 0x2F);
+}
 
 Aw9523::~Aw9523() {}
 
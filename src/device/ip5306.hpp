@@ -39,7 +39,12 @@ class Ip5306 : public I2cDevice
         V_4_2_4_305_4_35_4_395 = 0b11
     };
 
-    Ip5306(Logger& logger) : I2cDevice(logger) {}
+    Ip5306(Logger& logger) : I2cDevice(logger)
+    {
+        // 控制寄存器可缓存; REG_READ0..3 为状态寄存器, 保持 volatile
+        CacheRegisters(REG_SYS_CTL0, REG_SYS_CTL2);
+        CacheRegisters(REG_CHARGER_CTL0, REG_CHG_DIG_CTL0);
+    }
 
     ~Ip5306() = default;
 
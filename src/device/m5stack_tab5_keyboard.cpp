@@ -88,7 +88,7 @@ bool M5Tab5Keyboard::SetRgb(uint8_t index, uint8_t r, uint8_t g, uint8_t b)
     // 步长为 4，不能用 index*3
     const uint8_t buf[3] = {b, g, r};
     const uint8_t reg_addr = static_cast<uint8_t>(REG_RGB_COLOR_BASE + index * 4u);
-    if (!WriteRegBytes(reg_addr, {buf, buf + 3}, kI2cTimeoutMs))
+    if (!WriteRegBytes(reg_addr, buf, kI2cTimeoutMs))
     {
         logger_.Warning("SetRgb: I2C write failed");
         return false;
@@ -100,7 +100,7 @@ bool M5Tab5Keyboard::SetBothRgb(uint8_t r, uint8_t g, uint8_t b)
 {
     // 7-byte window: [RGB1_B, RGB1_G, RGB1_R, Reserved(0), RGB2_B, RGB2_G, RGB2_R]
     const uint8_t buf[7] = {b, g, r, 0x00, b, g, r};
-    if (!WriteRegBytes(REG_RGB_COLOR_BASE, {buf, buf + 7}, kI2cTimeoutMs))
+    if (!WriteRegBytes(REG_RGB_COLOR_BASE, buf, kI2cTimeoutMs))
     {
         logger_.Warning("SetBothRgb: I2C write failed");
         return false;
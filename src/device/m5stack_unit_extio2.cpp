@@ -43,6 +43,7 @@ bool UnitExtio2::SetDigitalOutput(int pin, bool state)
 bool UnitExtio2::SetDigitalOutputs(uint8_t states)
 {
     GetLogger().Debug("SetDigitalOutputs: 0x%02X", states);
+    InvalidateCache(Reg::OUTPUT_CTL_IO0, Reg::OUTPUT_CTL_IO7);
     return WriteReg8(Reg::OUTPUTS_CTL, states, 1000) == true;
 }
 
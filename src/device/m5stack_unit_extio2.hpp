@@ -99,7 +99,12 @@ class UnitExtio2 : public I2cDevice
         BITS12 = 1
     };
 
-    UnitExtio2(Logger& logger) : I2cDevice(logger) {}
+    UnitExtio2(Logger& logger) : I2cDevice(logger)
+    {
+        // 模式与单路输出寄存器可缓存; OUTPUTS_CTL 是输出寄存器的别名, 写入时使缓存失效
+        CacheRegisters(Reg::MODE_IO0, Reg::MODE_IO7);
+        CacheRegisters(Reg::OUTPUT_CTL_IO0, Reg::OUTPUT_CTL_IO7);
+    }
 
     ~UnitExtio2() = default;
 
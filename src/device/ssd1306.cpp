@@ -0,0 +1,17 @@
+#include "ssd1306.hpp"
+
+namespace wrapper
+{
+
+bool Ssd1306::Init(const I2cBus& bus, int width, int height)
+{
+    vendor_config_.height = (uint8_t)height;
+    config_.panel_config.vendor_config = &vendor_config_;
+    if (!I2cDisplay::Init(bus, config_, esp_lcd_new_panel_ssd1306))
+        return false;
+
+    // 400 kHz I2C 下整帧 1 KB 约 25 ms, 页差分只发送变化的列
+    return page_diff_.Init(width, height, config_.io_config.scl_speed_hz);
+}
+
+}  // namespace wrapper
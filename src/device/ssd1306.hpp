@@ -1,6 +1,8 @@
 #pragma once
 
+#include "esp_lcd_panel_ssd1306.h"
 #include "wrapper/display.hpp"
+#include "wrapper/display-mono.hpp"
 
 namespace wrapper
 {
@@ -30,9 +32,24 @@ class Ssd1306 : public I2cDisplay
         nullptr                     // vendor_conf
     };
 
+    esp_lcd_panel_ssd1306_config_t vendor_config_{};
+    MonoPageDiff page_diff_{*this, logger_};
+
    public:
     Ssd1306(wrapper::Logger& logger) : I2cDisplay(logger) {}
     ~Ssd1306() = default;
+
+    // height 为 32 或 64; 同时初始化页差分刷新
+    bool Init(const I2cBus& bus, int width = 128, int height = 64);
+
+    // frame 为 GDDRAM 页格式, 只发送与上一帧不同的列区间
+    bool Flush(const uint8_t* frame) { return page_diff_.Flush(frame); }
+    // rows 为行优先 1 bpp (LVGL I1 去掉调色板后的数据), 打包为页格式后同样差分发送
+    bool FlushRows(const uint8_t* rows, size_t stride)
+    {
+        return page_diff_.FlushRows(rows, stride);
+    }
+    MonoPageDiff& GetPageDiff() { return page_diff_; }
 };
 
 }  // namespace wrapper
\ No newline at end of file
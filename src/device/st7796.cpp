@@ -11,6 +11,7 @@
 #include "driver/gpio.h"
 #include "esp_log.h"
 #include "esp_check.h"
+#include "esp_timer.h"
 
 static const char* TAG_ST7796 = "St7796";
 
@@ -29,8 +30,20 @@ typedef struct
     uint8_t fb_bits_per_pixel;
     uint8_t madctl_val;
     uint8_t colmod_val;
+    uint8_t init_state;
 } st7796_panel_t;
 
+// 复位/初始化状态; 每一步发出命令后给出进入下一步前的最短等待
+typedef enum : uint8_t
+{
+    ST7796_RESET_ASSERT,
+    ST7796_RESET_RELEASE,
+    ST7796_SLEEP_OUT,
+    ST7796_CONFIGURE,
+    ST7796_DISPLAY_ON,
+    ST7796_READY,
+} st7796_init_state_t;
+
 typedef struct
 {
     uint8_t cmd;
@@ -68,46 +81,94 @@ static esp_err_t panel_st7796_del(esp_lcd_panel_t* panel)
     return ESP_OK;
 }
 
-static esp_err_t panel_st7796_reset(esp_lcd_panel_t* panel)
+static esp_err_t panel_st7796_step(st7796_panel_t* ctx, uint32_t* delay_ms)
 {
-    st7796_panel_t* ctx = __containerof(panel, st7796_panel_t, base);
     esp_lcd_panel_io_handle_t io = ctx->io;
+    gpio_num_t reset_gpio = static_cast<gpio_num_t>(ctx->reset_gpio_num);
+    *delay_ms = 0;
 
-    if (ctx->reset_gpio_num >= 0)
+    switch (ctx->init_state)
     {
-        gpio_set_level(static_cast<gpio_num_t>(ctx->reset_gpio_num), ctx->reset_level);
-        vTaskDelay(pdMS_TO_TICKS(10));
-        gpio_set_level(static_cast<gpio_num_t>(ctx->reset_gpio_num), !ctx->reset_level);
-        vTaskDelay(pdMS_TO_TICKS(10));
+        case ST7796_RESET_ASSERT:
+            if (ctx->reset_gpio_num >= 0)
+            {
+                gpio_set_level(reset_gpio, ctx->reset_level);
+                *delay_ms = 10;
+                ctx->init_state = ST7796_RESET_RELEASE;
+            }
+            else
+            {
+                ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(io, LCD_CMD_SWRESET, nullptr, 0),
+                                    TAG_ST7796, "send SWRESET failed");
+                *delay_ms = 20;
+                ctx->init_state = ST7796_SLEEP_OUT;
+            }
+            break;
+        case ST7796_RESET_RELEASE:
+            gpio_set_level(reset_gpio, !ctx->reset_level);
+            *delay_ms = 10;
+            ctx->init_state = ST7796_SLEEP_OUT;
+            break;
+        case ST7796_SLEEP_OUT:
+            ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(io, LCD_CMD_SLPOUT, nullptr, 0),
+                                TAG_ST7796, "send SLPOUT failed");
+            *delay_ms = 120;
+            ctx->init_state = ST7796_CONFIGURE;
+            break;
+        case ST7796_CONFIGURE:
+            ESP_RETURN_ON_ERROR(
+                esp_lcd_panel_io_tx_param(io, LCD_CMD_MADCTL, (uint8_t[]){ctx->madctl_val}, 1),
+                TAG_ST7796, "send MADCTL failed");
+            ESP_RETURN_ON_ERROR(
+                esp_lcd_panel_io_tx_param(io, LCD_CMD_COLMOD, (uint8_t[]){ctx->colmod_val}, 1),
+                TAG_ST7796, "send COLMOD failed");
+            for (int i = 0; k_vendor_init_cmds[i].data_bytes != 0xff; ++i)
+            {
+                ESP_RETURN_ON_ERROR(
+                    esp_lcd_panel_io_tx_param(io, k_vendor_init_cmds[i].cmd,
+                                              k_vendor_init_cmds[i].data,
+                                              k_vendor_init_cmds[i].data_bytes),
+                    TAG_ST7796, "send vendor command 0x%02x failed", k_vendor_init_cmds[i].cmd);
+            }
+            ctx->init_state = ST7796_DISPLAY_ON;
+            break;
+        case ST7796_DISPLAY_ON:
+            ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(io, LCD_CMD_DISPON, nullptr, 0),
+                                TAG_ST7796, "send DISPON failed");
+            *delay_ms = 20;
+            ctx->init_state = ST7796_READY;
+            break;
+        default:
+            break;
     }
-    else
+    return ESP_OK;
+}
+
+// 阻塞执行到 until 状态 (esp_lcd_panel_reset / esp_lcd_panel_init 使用)
+static esp_err_t panel_st7796_run(st7796_panel_t* ctx, uint8_t until)
+{
+    while (ctx->init_state < until)
     {
-        esp_lcd_panel_io_tx_param(io, LCD_CMD_SWRESET, nullptr, 0);
-        vTaskDelay(pdMS_TO_TICKS(20));
+        uint32_t delay_ms = 0;
+        ESP_RETURN_ON_ERROR(panel_st7796_step(ctx, &delay_ms), TAG_ST7796, "init step failed");
+        if (delay_ms > 0)
+            vTaskDelay(pdMS_TO_TICKS(delay_ms));
     }
     return ESP_OK;
 }
 
-static esp_err_t panel_st7796_init(esp_lcd_panel_t* panel)
+static esp_err_t panel_st7796_reset(esp_lcd_panel_t* panel)
 {
     st7796_panel_t* ctx = __containerof(panel, st7796_panel_t, base);
-    esp_lcd_panel_io_handle_t io = ctx->io;
-
-    esp_lcd_panel_io_tx_param(io, LCD_CMD_SLPOUT, nullptr, 0);
-    vTaskDelay(pdMS_TO_TICKS(120));
-
-    esp_lcd_panel_io_tx_param(io, LCD_CMD_MADCTL, (uint8_t[]){ctx->madctl_val}, 1);
-    esp_lcd_panel_io_tx_param(io, LCD_CMD_COLMOD, (uint8_t[]){ctx->colmod_val}, 1);
-
-    for (int i = 0; k_vendor_init_cmds[i].data_bytes != 0xff; ++i)
-    {
-        esp_lcd_panel_io_tx_param(io, k_vendor_init_cmds[i].cmd, k_vendor_init_cmds[i].data,
-                                  k_vendor_init_cmds[i].data_bytes);
-    }
+    ctx->init_state = ST7796_RESET_ASSERT;
+    return panel_st7796_run(ctx, ST7796_SLEEP_OUT);
+}
 
-    esp_lcd_panel_io_tx_param(io, LCD_CMD_DISPON, nullptr, 0);
-    vTaskDelay(pdMS_TO_TICKS(20));
-    return ESP_OK;
+static esp_err_t panel_st7796_init(esp_lcd_panel_t* panel)
+{
+    st7796_panel_t* ctx = __containerof(panel, st7796_panel_t, base);
+    ctx->init_state = ST7796_SLEEP_OUT;
+    return panel_st7796_run(ctx, ST7796_READY);
 }
 
 static esp_err_t panel_st7796_draw_bitmap(
@@ -275,7 +336,75 @@ namespace wrapper
 
 bool St7796::Init(const SpiBus& bus, const SpiDisplayConfig& config)
 {
-    return SpiDisplay::Init(bus, config, esp_lcd_new_panel_st7796);
+    return BeginInit(bus, config) && FinishInit();
+}
+
+bool St7796::BeginInit(const SpiBus& bus, const SpiDisplayConfig& config)
+{
+    if (!CreatePanel(bus, config, esp_lcd_new_panel_st7796))
+        return false;
+
+    st7796_panel_t* ctx = __containerof(panel_handle_, st7796_panel_t, base);
+    ctx->init_state = ST7796_RESET_ASSERT;
+    init_pending_ = true;
+    init_start_us_ = esp_timer_get_time();
+    init_next_us_ = init_start_us_;
+    init_timing_ = {};
+    return ContinueInit();
+}
+
+bool St7796::ContinueInit()
+{
+    if (!init_pending_)
+        return panel_handle_ != nullptr;
+
+    st7796_panel_t* ctx = __containerof(panel_handle_, st7796_panel_t, base);
+    int64_t now = esp_timer_get_time();
+    while (now >= init_next_us_)
+    {
+        init_timing_.late_us += now - init_next_us_;
+        if (ctx->init_state == ST7796_READY)
+        {
+            init_pending_ = false;
+            init_timing_.elapsed_us = now - init_start_us_;
+            logger_.Info("Panel ready in %lld ms (%lld ms blocked, %lld ms late)",
+                         init_timing_.elapsed_us / 1000, init_timing_.blocked_us / 1000,
+                         init_timing_.late_us / 1000);
+            return true;
+        }
+
+        uint32_t delay_ms = 0;
+        esp_err_t err = panel_st7796_step(ctx, &delay_ms);
+        if (err != ESP_OK)
+        {
+            init_pending_ = false;
+            logger_.Error("Panel init step %u failed: %s", ctx->init_state,
+                          esp_err_to_name(err));
+            return false;
+        }
+        now = esp_timer_get_time();
+        init_next_us_ = now + (int64_t)delay_ms * 1000;
+    }
+    return true;
+}
+
+bool St7796::FinishInit()
+{
+    while (init_pending_)
+    {
+        int64_t wait_us = init_next_us_ - esp_timer_get_time();
+        if (wait_us > 0)
+        {
+            // 向上取整到节拍, 保证醒来时已到期
+            int64_t start = esp_timer_get_time();
+            vTaskDelay((TickType_t)((wait_us + portTICK_PERIOD_MS * 1000 - 1) /
+                                    (portTICK_PERIOD_MS * 1000)));
+            init_timing_.blocked_us += esp_timer_get_time() - start;
+        }
+        if (!ContinueInit())
+            return false;
+    }
+    return panel_handle_ != nullptr;
 }
 
 }  // namespace wrapper
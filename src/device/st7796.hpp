@@ -18,6 +18,30 @@ class St7796 : public SpiDisplay
     using SpiDisplay::SpiDisplay;  // Inherit constructor
 
     bool Init(const SpiBus& bus, const SpiDisplayConfig& config);
+
+    /**
+     * @brief 分步初始化
+     *
+     * 复位与唤醒共有约 160 ms 的固定等待 (复位 10 + 10 ms, SLPOUT 后 120 ms, DISPON 后 20 ms).
+     * BeginInit() 发出第一步后立即返回, 调用方在等待窗口内初始化其它外设, 其间调用
+     * ContinueInit() 执行已到期的步骤, 最后 FinishInit() 等待并执行剩余步骤.
+     * Init() 等价于 BeginInit() + FinishInit().
+     *
+     * @note 完成前不得绘制或调用其它面板操作; 窗口内的工作不得占用本面板的 SPI 设备.
+     */
+    bool BeginInit(const SpiBus& bus, const SpiDisplayConfig& config);
+    bool ContinueInit();  // 不阻塞
+    bool FinishInit();
+    bool IsInitPending() const { return init_pending_; }
+    // 下一步的最早时间 (esp_timer_get_time 时基)
+    int64_t GetNextStepTime() const { return init_next_us_; }
+    PanelInitTiming GetInitTiming() const { return init_timing_; }
+
+   private:
+    bool init_pending_ = false;
+    int64_t init_start_us_ = 0;
+    int64_t init_next_us_ = 0;
+    PanelInitTiming init_timing_;
 };
 
 }  // namespace wrapper
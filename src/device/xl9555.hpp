@@ -57,13 +57,7 @@ class Xl9555
 
    private:
     Logger& logger_;
-    I2cDevice device_;
-
-    // Write-through cache for output and config registers
-    uint8_t output_p0_{0xFF};
-    uint8_t output_p1_{0xFF};
-    uint8_t config_p0_{0xFF};
-    uint8_t config_p1_{0xFF};
+    I2cDevice device_;  // output/inversion/config registers are shadowed by the register cache
 };
 
 }  // namespace wrapper
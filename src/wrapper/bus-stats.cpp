@@ -0,0 +1,160 @@
+#include "wrapper/bus-stats.hpp"
+#include "wrapper/console.hpp"
+#include "freertos/semphr.h"
+#include <cstdarg>
+#include <cstring>
+
+using namespace wrapper;
+
+#ifdef CONFIG_WRAPPER_ESP32_BUS_STATS
+
+// --- Registry ---
+
+namespace
+{
+
+BusStats* g_head = nullptr;
+
+SemaphoreHandle_t RegistryLock()
+{
+    static StaticSemaphore_t buffer;
+    static SemaphoreHandle_t lock = xSemaphoreCreateMutexStatic(&buffer);
+    return lock;
+}
+
+}  // namespace
+
+// --- BusStats ---
+
+void BusStats::Attach(const char* fmt, ...)
+{
+    xSemaphoreTake(RegistryLock(), portMAX_DELAY);
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(name_, sizeof(name_), fmt, args);
+    va_end(args);
+    if (!attached_)
+    {
+        next_ = g_head;
+        g_head = this;
+        attached_ = true;
+    }
+    xSemaphoreGive(RegistryLock());
+}
+
+void BusStats::Detach()
+{
+    if (!attached_)
+        return;
+    xSemaphoreTake(RegistryLock(), portMAX_DELAY);
+    for (BusStats** link = &g_head; *link != nullptr; link = &(*link)->next_)
+    {
+        if (*link == this)
+        {
+            *link = next_;
+            break;
+        }
+    }
+    next_ = nullptr;
+    attached_ = false;
+    xSemaphoreGive(RegistryLock());
+}
+
+BusStatsSnapshot BusStats::Snapshot() const
+{
+    taskENTER_CRITICAL(&lock_);
+    BusStatsSnapshot copy = data_;
+    taskEXIT_CRITICAL(&lock_);
+    return copy;
+}
+
+void BusStats::Reset()
+{
+    taskENTER_CRITICAL(&lock_);
+    data_ = {};
+    taskEXIT_CRITICAL(&lock_);
+}
+
+const char* BusStats::GetName() const { return name_; }
+
+void BusStats::Print(FILE* out) const
+{
+    BusStatsSnapshot s = Snapshot();
+    unsigned avg = s.transactions ? (unsigned)(s.total_us / s.transactions) : 0;
+    fprintf(out, "%-16s n=%lu bytes=%llu err=%lu tmo=%lu busy=%llu us avg=%u us max=%lu us\n",
+            name_, (unsigned long)s.transactions, (unsigned long long)s.bytes,
+            (unsigned long)s.errors, (unsigned long)s.timeouts, (unsigned long long)s.total_us,
+            avg, (unsigned long)s.max_us);
+    if (s.transactions == 0)
+        return;
+
+    fprintf(out, "%-16s", "");
+    for (int i = 0; i < BusStatsSnapshot::kBuckets; i++)
+    {
+        if (s.histogram[i] == 0)
+            continue;
+        if (i == BusStatsSnapshot::kBuckets - 1)
+            fprintf(out, " >=%luus:%lu", 1ul << i, (unsigned long)s.histogram[i]);
+        else
+            fprintf(out, " <%luus:%lu", 2ul << i, (unsigned long)s.histogram[i]);
+    }
+    fprintf(out, "\n");
+}
+
+void BusStats::PrintAll(FILE* out)
+{
+    xSemaphoreTake(RegistryLock(), portMAX_DELAY);
+    for (BusStats* s = g_head; s != nullptr; s = s->next_)
+    {
+        s->Print(out);
+    }
+    xSemaphoreGive(RegistryLock());
+}
+
+void BusStats::ResetAll()
+{
+    xSemaphoreTake(RegistryLock(), portMAX_DELAY);
+    for (BusStats* s = g_head; s != nullptr; s = s->next_)
+    {
+        s->Reset();
+    }
+    xSemaphoreGive(RegistryLock());
+}
+
+#else  // CONFIG_WRAPPER_ESP32_BUS_STATS
+
+void BusStats::Attach(const char*, ...) {}
+void BusStats::Detach() {}
+BusStatsSnapshot BusStats::Snapshot() const { return {}; }
+void BusStats::Reset() {}
+const char* BusStats::GetName() const { return ""; }
+void BusStats::Print(FILE*) const {}
+
+void BusStats::PrintAll(FILE* out)
+{
+    fprintf(out, "bus statistics disabled (CONFIG_WRAPPER_ESP32_BUS_STATS)\n");
+}
+
+void BusStats::ResetAll() {}
+
+#endif  // CONFIG_WRAPPER_ESP32_BUS_STATS
+
+// --- Console ---
+
+static int BusStatsCommand(int argc, char** argv)
+{
+    if (argc > 1 && strcmp(argv[1], "reset") == 0)
+    {
+        BusStats::ResetAll();
+        printf("bus statistics reset\n");
+        return 0;
+    }
+    BusStats::PrintAll(stdout);
+    return 0;
+}
+
+bool BusStats::RegisterCommand(Console& console)
+{
+    return console.RegisterCommand(ConsoleCommand(
+        "busstats", "Print I2C/SPI per-device transaction statistics", "[reset]", BusStatsCommand));
+}
@@ -0,0 +1,108 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include "esp_err.h"
+#include "sdkconfig.h"
+#include "freertos/FreeRTOS.h"
+
+namespace wrapper
+{
+
+class Console;
+
+/**
+ * @brief 总线统计快照
+ *
+ * histogram[i] 统计耗时落在 [2^i, 2^(i+1)) us 的事务, 第 0 桶包含 0 us,
+ * 最后一桶不设上限 (>= 2^(kBuckets-1) us, 约 32 ms).
+ */
+struct BusStatsSnapshot
+{
+    static constexpr int kBuckets = 16;
+
+    uint32_t transactions = 0;
+    uint32_t errors = 0;
+    uint32_t timeouts = 0;
+    uint32_t max_us = 0;
+    uint64_t bytes = 0;
+    uint64_t total_us = 0;
+    uint32_t histogram[kBuckets] = {};
+};
+
+/**
+ * @brief 每设备/每总线的传输计数与 log2 延迟直方图
+ *
+ * 由 CONFIG_WRAPPER_ESP32_BUS_STATS 控制; 关闭时不占用存储, Record() 为空函数.
+ * Attach() 后对象挂入全局链表, 可通过 "busstats" 控制台命令打印.
+ */
+class BusStats
+{
+   public:
+#ifdef CONFIG_WRAPPER_ESP32_BUS_STATS
+    static constexpr bool kEnabled = true;
+#else
+    static constexpr bool kEnabled = false;
+#endif
+
+    BusStats() = default;
+    ~BusStats() { Detach(); }
+
+    BusStats(const BusStats&) = delete;
+    BusStats& operator=(const BusStats&) = delete;
+
+    // 以 printf 格式命名并加入全局链表; 重复调用仅更新名字
+    void Attach(const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+    void Detach();
+
+    inline void Record(size_t bytes, esp_err_t err, uint32_t elapsed_us)
+    {
+#ifdef CONFIG_WRAPPER_ESP32_BUS_STATS
+        int bucket = elapsed_us == 0 ? 0 : 31 - __builtin_clz(elapsed_us);
+        if (bucket >= BusStatsSnapshot::kBuckets)
+            bucket = BusStatsSnapshot::kBuckets - 1;
+
+        taskENTER_CRITICAL(&lock_);
+        data_.transactions++;
+        data_.bytes += bytes;
+        data_.total_us += elapsed_us;
+        if (elapsed_us > data_.max_us)
+            data_.max_us = elapsed_us;
+        data_.histogram[bucket]++;
+        if (err == ESP_ERR_TIMEOUT)
+            data_.timeouts++;
+        else if (err != ESP_OK)
+            data_.errors++;
+        taskEXIT_CRITICAL(&lock_);
+#else
+        (void)bytes;
+        (void)err;
+        (void)elapsed_us;
+#endif
+    }
+
+    BusStatsSnapshot Snapshot() const;
+    void Reset();
+    const char* GetName() const;
+    void Print(FILE* out) const;
+
+    // 遍历全部已挂载的统计对象
+    static void PrintAll(FILE* out);
+    static void ResetAll();
+
+    // 注册 "busstats [reset]" 控制台命令
+    static bool RegisterCommand(Console& console);
+
+   private:
+#ifdef CONFIG_WRAPPER_ESP32_BUS_STATS
+    static constexpr size_t kNameSize = 20;
+
+    mutable portMUX_TYPE lock_ = portMUX_INITIALIZER_UNLOCKED;
+    BusStatsSnapshot data_;
+    char name_[kNameSize] = {};
+    bool attached_ = false;
+    BusStats* next_ = nullptr;
+#endif
+};
+
+}  // namespace wrapper
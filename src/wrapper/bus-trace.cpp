@@ -0,0 +1,196 @@
+#include "wrapper/bus-trace.hpp"
+#include "wrapper/console.hpp"
+#include "freertos/FreeRTOS.h"
+#include <cstdlib>
+#include <cstring>
+
+using namespace wrapper;
+
+#ifdef CONFIG_WRAPPER_ESP32_BUS_TRACE
+
+// --- Ring ---
+
+namespace
+{
+
+constexpr size_t kDepth = CONFIG_WRAPPER_ESP32_BUS_TRACE_DEPTH;
+
+BusTraceRecord g_records[kDepth];
+size_t g_head = 0;      // 下一条写入位置
+size_t g_count = 0;     // 有效记录数
+uint32_t g_dropped = 0;  // 被覆盖的记录数
+portMUX_TYPE g_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// 在锁内复制出按时间排序的第 index 条记录
+BusTraceRecord At(size_t index)
+{
+    size_t start = (g_head + kDepth - g_count) % kDepth;
+    return g_records[(start + index) % kDepth];
+}
+
+}  // namespace
+
+// --- BusTrace ---
+
+void BusTrace::Record(uint16_t device,
+                      BusTraceKind kind,
+                      uint8_t reg,
+                      size_t length,
+                      esp_err_t result,
+                      int64_t start_us,
+                      uint32_t duration_us)
+{
+    BusTraceRecord record = {};
+    record.timestamp_us = (uint32_t)start_us;
+    record.duration_us = duration_us;
+    record.result = result;
+    record.device = device;
+    record.length = length > 0xFFFF ? 0xFFFF : (uint16_t)length;
+    record.kind = (uint8_t)kind;
+    record.reg = reg;
+
+    taskENTER_CRITICAL(&g_lock);
+    g_records[g_head] = record;
+    g_head = (g_head + 1) % kDepth;
+    if (g_count < kDepth)
+        g_count++;
+    else
+        g_dropped++;
+    taskEXIT_CRITICAL(&g_lock);
+}
+
+void BusTrace::Clear()
+{
+    taskENTER_CRITICAL(&g_lock);
+    g_head = 0;
+    g_count = 0;
+    g_dropped = 0;
+    taskEXIT_CRITICAL(&g_lock);
+}
+
+size_t BusTrace::Count()
+{
+    taskENTER_CRITICAL(&g_lock);
+    size_t count = g_count;
+    taskEXIT_CRITICAL(&g_lock);
+    return count;
+}
+
+size_t BusTrace::Dump(FILE* out)
+{
+    // 逐条在锁内复制, 写文件时不持锁; 导出期间的新记录可能使结果略有错位
+    taskENTER_CRITICAL(&g_lock);
+    uint32_t count = (uint32_t)g_count;
+    uint32_t dropped = g_dropped;
+    taskEXIT_CRITICAL(&g_lock);
+
+    uint8_t header[16] = {'W', 'B', 'T', 'R'};
+    uint16_t version = kFormatVersion;
+    uint16_t record_size = sizeof(BusTraceRecord);
+    memcpy(header + 4, &version, 2);
+    memcpy(header + 6, &record_size, 2);
+    memcpy(header + 8, &count, 4);
+    memcpy(header + 12, &dropped, 4);
+    if (fwrite(header, sizeof(header), 1, out) != 1)
+        return 0;
+
+    size_t written = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        taskENTER_CRITICAL(&g_lock);
+        BusTraceRecord record = At(i);
+        taskEXIT_CRITICAL(&g_lock);
+        if (fwrite(&record, sizeof(record), 1, out) != 1)
+            break;
+        written++;
+    }
+    return written;
+}
+
+bool BusTrace::Save(const char* path)
+{
+    FILE* file = fopen(path, "wb");
+    if (file == nullptr)
+        return false;
+    size_t count = Count();
+    size_t written = Dump(file);
+    return fclose(file) == 0 && written == count;
+}
+
+void BusTrace::Print(FILE* out, size_t max_records)
+{
+    static const char* const kKindNames[] = {"wr", "rd", "wr-rd", "mwr", "exec", "spi"};
+
+    size_t count = Count();
+    size_t first = count > max_records ? count - max_records : 0;
+    for (size_t i = first; i < count; i++)
+    {
+        taskENTER_CRITICAL(&g_lock);
+        BusTraceRecord r = At(i);
+        taskEXIT_CRITICAL(&g_lock);
+        const char* kind = r.kind < sizeof(kKindNames) / sizeof(kKindNames[0])
+                               ? kKindNames[r.kind]
+                               : "?";
+        fprintf(out, "%10lu %s%d:%02X %-5s reg=%02X len=%u %lu us %s\n",
+                (unsigned long)r.timestamp_us, (r.device & 0x8000) ? "spi" : "i2c",
+                (r.device >> 8) & 0x7F, r.device & 0xFF, kind, r.reg, r.length,
+                (unsigned long)r.duration_us, r.result == ESP_OK ? "ok" : esp_err_to_name(r.result));
+    }
+}
+
+#else  // CONFIG_WRAPPER_ESP32_BUS_TRACE
+
+void BusTrace::Record(uint16_t, BusTraceKind, uint8_t, size_t, esp_err_t, int64_t, uint32_t) {}
+void BusTrace::Clear() {}
+size_t BusTrace::Count() { return 0; }
+size_t BusTrace::Dump(FILE*) { return 0; }
+bool BusTrace::Save(const char*) { return false; }
+
+void BusTrace::Print(FILE* out, size_t)
+{
+    fprintf(out, "bus trace disabled (CONFIG_WRAPPER_ESP32_BUS_TRACE)\n");
+}
+
+#endif  // CONFIG_WRAPPER_ESP32_BUS_TRACE
+
+// --- Console ---
+
+static int BusTraceCommand(int argc, char** argv)
+{
+    if (argc > 1 && strcmp(argv[1], "clear") == 0)
+    {
+        BusTrace::Clear();
+        printf("bus trace cleared\n");
+        return 0;
+    }
+    if (argc > 1 && strcmp(argv[1], "save") == 0)
+    {
+        if (argc < 3)
+        {
+            printf("usage: bustrace save <path>\n");
+            return 1;
+        }
+        if (!BusTrace::Save(argv[2]))
+        {
+            printf("failed to save trace to %s\n", argv[2]);
+            return 1;
+        }
+        printf("saved %u records to %s\n", (unsigned)BusTrace::Count(), argv[2]);
+        return 0;
+    }
+    size_t max_records = 32;
+    if (argc > 2 && strcmp(argv[1], "print") == 0)
+    {
+        max_records = (size_t)strtoul(argv[2], nullptr, 10);
+    }
+    BusTrace::Print(stdout, max_records);
+    return 0;
+}
+
+bool BusTrace::RegisterCommand(Console& console)
+{
+    return console.RegisterCommand(ConsoleCommand("bustrace",
+                                                  "Show, save or clear the I2C/SPI transaction trace",
+                                                  "[print [n] | save <path> | clear]",
+                                                  BusTraceCommand));
+}
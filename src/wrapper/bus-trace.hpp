@@ -0,0 +1,91 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include "esp_err.h"
+#include "sdkconfig.h"
+
+namespace wrapper
+{
+
+class Console;
+
+enum class BusTraceKind : uint8_t
+{
+    I2cWrite = 0,
+    I2cRead = 1,
+    I2cWriteRead = 2,
+    I2cMultiWrite = 3,
+    I2cExecute = 4,
+    SpiTransfer = 5,
+};
+
+/**
+ * @brief 单条事务记录 (20 字节, 小端, 按字段顺序紧凑排列)
+ *
+ * device: I2C 为 (port << 8) | 7 位地址; SPI 为 0x8000 | (host << 8) | CS 引脚.
+ * reg: 事务首个寄存器/地址字节, 无则为 0.
+ */
+struct __attribute__((packed)) BusTraceRecord
+{
+    uint32_t timestamp_us;
+    uint32_t duration_us;
+    int32_t result;
+    uint16_t device;
+    uint16_t length;
+    uint8_t kind;
+    uint8_t reg;
+    uint16_t reserved;
+};
+static_assert(sizeof(BusTraceRecord) == 20, "trace record layout is part of the dump format");
+
+/**
+ * @brief 全局 I2C/SPI 事务跟踪环形缓冲
+ *
+ * 由 CONFIG_WRAPPER_ESP32_BUS_TRACE 控制, 容量为 CONFIG_WRAPPER_ESP32_BUS_TRACE_DEPTH 条,
+ * 写满后覆盖最旧记录. 关闭时 Record() 为空函数.
+ *
+ * 二进制导出格式: 16 字节文件头 {"WBTR", u16 版本, u16 记录大小, u32 记录数, u32 丢弃数},
+ * 随后按时间从旧到新排列的 BusTraceRecord. 主机端回放工具按此格式解析.
+ */
+class BusTrace
+{
+   public:
+#ifdef CONFIG_WRAPPER_ESP32_BUS_TRACE
+    static constexpr bool kEnabled = true;
+#else
+    static constexpr bool kEnabled = false;
+#endif
+    static constexpr uint16_t kFormatVersion = 1;
+
+    static inline uint16_t I2cId(int port, uint16_t addr)
+    {
+        return (uint16_t)(((port & 0x7F) << 8) | (addr & 0xFF));
+    }
+    static inline uint16_t SpiId(int host, int cs)
+    {
+        return (uint16_t)(0x8000 | ((host & 0x7F) << 8) | (cs & 0xFF));
+    }
+
+    static void Record(uint16_t device,
+                       BusTraceKind kind,
+                       uint8_t reg,
+                       size_t length,
+                       esp_err_t result,
+                       int64_t start_us,
+                       uint32_t duration_us);
+
+    static void Clear();
+    static size_t Count();
+
+    // 二进制导出 (可直接写入 SD 卡文件), 返回写出的记录数
+    static size_t Dump(FILE* out);
+    static bool Save(const char* path);
+    // 文本导出, 供控制台查看最近 max_records 条
+    static void Print(FILE* out, size_t max_records);
+
+    // 注册 "bustrace [print [n] | save <path> | clear]" 控制台命令
+    static bool RegisterCommand(Console& console);
+};
+
+}  // namespace wrapper
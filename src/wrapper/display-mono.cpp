@@ -0,0 +1,172 @@
+#include "wrapper/display-mono.hpp"
+#include "wrapper/pixel.hpp"
+#include <cstdlib>
+#include <cstring>
+
+using namespace wrapper;
+
+// --- MonoPageDiff ---
+
+MonoPageDiff::MonoPageDiff(DisplayBase& display, Logger& logger)
+    : display_(display),
+      logger_(logger),
+      width_(0),
+      height_(0),
+      scl_hz_(400000),
+      gap_bytes_(kWindowOverheadBytes),
+      shadow_(nullptr),
+      pages_(nullptr),
+      valid_(false),
+      last_{}
+{
+}
+
+MonoPageDiff::~MonoPageDiff() { Deinit(); }
+
+bool MonoPageDiff::Init(int width, int height, uint32_t scl_hz)
+{
+    Deinit();
+    if (width <= 0 || height <= 0 || height % 8 != 0 || scl_hz == 0)
+    {
+        logger_.Error("Invalid geometry %dx%d", width, height);
+        return false;
+    }
+    if (display_.GetBitsPerPixel() != 1)
+    {
+        logger_.Error("Page diff needs a 1 bpp panel, got %u bpp",
+                      (unsigned)display_.GetBitsPerPixel());
+        return false;
+    }
+
+    shadow_ = static_cast<uint8_t*>(malloc((size_t)width * height / 8));
+    if (shadow_ == nullptr)
+    {
+        logger_.Error("Failed to allocate shadow buffer");
+        return false;
+    }
+    width_ = width;
+    height_ = height;
+    scl_hz_ = scl_hz;
+    valid_ = false;
+    last_ = {};
+    return true;
+}
+
+void MonoPageDiff::Deinit()
+{
+    free(shadow_);
+    shadow_ = nullptr;
+    free(pages_);
+    pages_ = nullptr;
+    valid_ = false;
+}
+
+uint32_t MonoPageDiff::EstimateUs(uint32_t spans, uint32_t bytes) const
+{
+    // I2C 每字节 9 个时钟 (含 ACK)
+    uint64_t total = (uint64_t)spans * kWindowOverheadBytes + bytes;
+    return (uint32_t)(total * 9 * 1000000 / scl_hz_);
+}
+
+MonoPageDiff::FlushStats MonoPageDiff::GetFullFrameCost() const
+{
+    FlushStats full = {};
+    full.pages = (uint32_t)(height_ / 8);
+    full.spans = 1;
+    full.bytes = (uint32_t)(width_ * height_ / 8);
+    full.bus_us = EstimateUs(full.spans, full.bytes);
+    return full;
+}
+
+bool MonoPageDiff::FlushPage(int page, const uint8_t* frame)
+{
+    const uint8_t* src = frame + (size_t)page * width_;
+    uint8_t* shadow = shadow_ + (size_t)page * width_;
+    if (valid_ && memcmp(src, shadow, width_) == 0)
+        return true;
+
+    last_.pages++;
+    int x = 0;
+    while (x < width_)
+    {
+        // 找到下一个变化区间 [start, end), 间隔不超过 gap_bytes_ 的区间并入
+        while (valid_ && x < width_ && src[x] == shadow[x])
+            x++;
+        if (x == width_)
+            break;
+        int start = x;
+        int end = x + 1;
+        for (x = end; x < width_; x++)
+        {
+            if (!valid_ || src[x] != shadow[x])
+            {
+                end = x + 1;
+            }
+            else if ((size_t)(x - end) >= gap_bytes_)
+            {
+                break;
+            }
+        }
+
+        if (!display_.DrawBitmap(start, page * 8, end, page * 8 + 8, src + start))
+        {
+            return false;
+        }
+        memcpy(shadow + start, src + start, end - start);
+        last_.spans++;
+        last_.bytes += (uint32_t)(end - start);
+        x = end;
+    }
+    return true;
+}
+
+bool MonoPageDiff::Flush(const uint8_t* frame)
+{
+    if (shadow_ == nullptr)
+    {
+        logger_.Error("Not initialized");
+        return false;
+    }
+
+    last_ = {};
+    for (int page = 0; page < height_ / 8; page++)
+    {
+        if (!FlushPage(page, frame))
+        {
+            logger_.Error("Flush failed at page %d", page);
+            // 部分区间可能已写入, 面板内容不再可知
+            valid_ = false;
+            return false;
+        }
+    }
+    valid_ = true;
+    last_.bus_us = EstimateUs(last_.spans, last_.bytes);
+    return display_.WaitColorDone();
+}
+
+bool MonoPageDiff::FlushRows(const uint8_t* rows, size_t stride)
+{
+    if (shadow_ == nullptr)
+    {
+        logger_.Error("Not initialized");
+        return false;
+    }
+    if (width_ % 8 != 0 || stride < (size_t)width_ / 8)
+    {
+        logger_.Error("Row-major flush needs width %% 8 == 0, got %d (stride %u)", width_,
+                      (unsigned)stride);
+        return false;
+    }
+    if (pages_ == nullptr)
+    {
+        pages_ = static_cast<uint8_t*>(malloc((size_t)width_ * height_ / 8));
+        if (pages_ == nullptr)
+        {
+            logger_.Error("Failed to allocate page buffer");
+            return false;
+        }
+    }
+
+    PixelOps::PackPages(pages_, rows, width_, height_, stride);
+    return Flush(pages_);
+}
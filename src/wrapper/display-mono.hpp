@@ -0,0 +1,78 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "wrapper/display.hpp"
+#include "wrapper/logger.hpp"
+
+namespace wrapper
+{
+
+/**
+ * @brief 1 bpp 面板 (SSD1306 等) 的页差分刷新
+ *
+ * 保存一份面板 GDDRAM 的影子副本, Flush() 时逐页 (8 行) 与新帧比较, 只发送变化的列区间;
+ * 每个区间为一次 draw_bitmap, 由面板驱动以列地址/页地址命令设置窗口.
+ * 两个区间之间未变化的列少于 gap_bytes 时合并发送, 比多一组寻址命令更便宜.
+ *
+ * 帧格式与 GDDRAM 相同: 每页 width 字节, 每字节为一列的 8 个像素, bit0 为页内最上一行.
+ * 页格式下同一页内的列区间在帧中连续, 发送时直接引用帧数据, 无需拷贝.
+ */
+class MonoPageDiff
+{
+   public:
+    struct FlushStats
+    {
+        uint32_t pages;  // 有变化的页数
+        uint32_t spans;  // 发送的列区间数
+        uint32_t bytes;  // 像素字节数
+        uint32_t bus_us;  // 按总线时钟估算的传输时间 (含寻址命令)
+    };
+
+    MonoPageDiff(DisplayBase& display, Logger& logger);
+    ~MonoPageDiff();
+
+    MonoPageDiff(const MonoPageDiff&) = delete;
+    MonoPageDiff& operator=(const MonoPageDiff&) = delete;
+
+    // height 须为 8 的倍数; scl_hz 仅用于估算传输时间
+    bool Init(int width, int height, uint32_t scl_hz = 400000);
+    void Deinit();
+
+    // 合并阈值, 默认为一组寻址命令的开销
+    void SetGapBytes(size_t bytes) { gap_bytes_ = bytes; }
+    // 影子失效 (面板复位、睡眠唤醒或被其它路径写入后), 下一次 Flush 发送整帧
+    void Invalidate() { valid_ = false; }
+
+    bool Flush(const uint8_t* frame);
+    /**
+     * @brief 行优先 1 bpp 帧 (MSB 为最左像素) 的差分刷新
+     *
+     * 用 PixelOps::PackPages 打包到页格式暂存区 (首次调用时分配) 后按 Flush() 发送.
+     * width 须为 8 的倍数; stride 为源每行字节数.
+     */
+    bool FlushRows(const uint8_t* rows, size_t stride);
+
+    FlushStats GetLastFlush() const { return last_; }
+    // 同样条件下整帧刷新的估算, 便于与 GetLastFlush() 对比
+    FlushStats GetFullFrameCost() const;
+
+   private:
+    // 一组列/页寻址命令 (两次 tx_param) 加一次数据写的包头, 按字节计
+    static constexpr size_t kWindowOverheadBytes = 12;
+
+    DisplayBase& display_;
+    Logger& logger_;
+    int width_;
+    int height_;
+    uint32_t scl_hz_;
+    size_t gap_bytes_;
+    uint8_t* shadow_;
+    uint8_t* pages_;  // FlushRows 的页格式暂存区
+    bool valid_;
+    FlushStats last_;
+
+    uint32_t EstimateUs(uint32_t spans, uint32_t bytes) const;
+    bool FlushPage(int page, const uint8_t* frame);
+};
+
+}  // namespace wrapper
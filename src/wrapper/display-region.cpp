@@ -0,0 +1,234 @@
+#include "wrapper/display-region.hpp"
+#include "esp_heap_caps.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace wrapper;
+
+// --- DirtyRegions ---
+
+DirtyRegions::DirtyRegions(DisplayBase& display, Logger& logger)
+    : display_(display),
+      logger_(logger),
+      width_(0),
+      height_(0),
+      mono_(false),
+      pixel_bytes_(2),
+      window_cost_(256),
+      scratch_(nullptr),
+      scratch_bytes_(0),
+      rects_{},
+      count_(0),
+      invalidated_(0),
+      last_{}
+{
+}
+
+DirtyRegions::~DirtyRegions() { Deinit(); }
+
+bool DirtyRegions::Init(int width, int height, size_t scratch_bytes)
+{
+    Deinit();
+
+    uint32_t bpp = display_.GetBitsPerPixel();
+    mono_ = bpp == 1;
+    pixel_bytes_ = (bpp + 7) / 8;
+    window_cost_ = mono_ ? 16 : 256;
+    width_ = width;
+    height_ = height;
+
+    if (width <= 0 || height <= 0 || (mono_ && height % 8 != 0))
+    {
+        logger_.Error("Invalid geometry %dx%d (%u bpp)", width, height, (unsigned)bpp);
+        return false;
+    }
+    if (scratch_bytes < LineBytes(width))
+    {
+        logger_.Error("Scratch buffer %u bytes is smaller than one line (%u bytes)",
+                      (unsigned)scratch_bytes, (unsigned)LineBytes(width));
+        return false;
+    }
+
+    scratch_ = static_cast<uint8_t*>(heap_caps_malloc(scratch_bytes, MALLOC_CAP_DMA));
+    if (scratch_ == nullptr)
+    {
+        logger_.Error("Failed to allocate %u byte scratch buffer", (unsigned)scratch_bytes);
+        return false;
+    }
+    scratch_bytes_ = scratch_bytes;
+    Clear();
+    return true;
+}
+
+void DirtyRegions::Deinit()
+{
+    if (scratch_ != nullptr)
+    {
+        heap_caps_free(scratch_);
+        scratch_ = nullptr;
+    }
+    scratch_bytes_ = 0;
+    count_ = 0;
+}
+
+void DirtyRegions::Clear()
+{
+    count_ = 0;
+    invalidated_ = 0;
+}
+
+// --- DirtyRegions accumulation ---
+
+DisplayRect DirtyRegions::Bounds(const DisplayRect& a, const DisplayRect& b)
+{
+    return {std::min(a.x0, b.x0), std::min(a.y0, b.y0), std::max(a.x1, b.x1),
+            std::max(a.y1, b.y1)};
+}
+
+void DirtyRegions::Remove(size_t index)
+{
+    rects_[index] = rects_[--count_];
+}
+
+void DirtyRegions::Invalidate(int x0, int y0, int x1, int y1)
+{
+    DisplayRect r = {std::max(x0, 0), std::max(y0, 0), std::min(x1, width_),
+                     std::min(y1, height_)};
+    if (mono_)
+    {
+        r.y0 &= ~7;
+        r.y1 = (r.y1 + 7) & ~7;
+    }
+    if (r.Empty())
+        return;
+
+    invalidated_++;
+    // 已被覆盖的矩形直接丢弃, 这是 UI 重绘中最常见的情况
+    for (size_t i = 0; i < count_; i++)
+    {
+        const DisplayRect& c = rects_[i];
+        if (c.x0 <= r.x0 && c.y0 <= r.y0 && c.x1 >= r.x1 && c.y1 >= r.y1)
+            return;
+    }
+    if (count_ == kMaxRects)
+    {
+        MergeCheapestPair();
+    }
+    rects_[count_++] = r;
+}
+
+void DirtyRegions::Merge()
+{
+    // 反复合并 "包围盒不比分开发送更贵" 的矩形对; 合并后的矩形可能触发新的合并
+    bool merged = true;
+    while (merged)
+    {
+        merged = false;
+        for (size_t i = 0; i < count_ && !merged; i++)
+        {
+            for (size_t j = i + 1; j < count_; j++)
+            {
+                DisplayRect bounds = Bounds(rects_[i], rects_[j]);
+                if (Cost(bounds) <= Cost(rects_[i]) + Cost(rects_[j]))
+                {
+                    rects_[i] = bounds;
+                    Remove(j);
+                    merged = true;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+void DirtyRegions::MergeCheapestPair()
+{
+    size_t best_i = 0;
+    size_t best_j = 1;
+    int64_t best_delta = INT64_MAX;
+    for (size_t i = 0; i < count_; i++)
+    {
+        for (size_t j = i + 1; j < count_; j++)
+        {
+            int64_t delta = (int64_t)Cost(Bounds(rects_[i], rects_[j])) -
+                            (int64_t)Cost(rects_[i]) - (int64_t)Cost(rects_[j]);
+            if (delta < best_delta)
+            {
+                best_delta = delta;
+                best_i = i;
+                best_j = j;
+            }
+        }
+    }
+    rects_[best_i] = Bounds(rects_[best_i], rects_[best_j]);
+    Remove(best_j);
+}
+
+// --- DirtyRegions flush ---
+
+bool DirtyRegions::FlushRect(const DisplayRect& r, const uint8_t* framebuffer)
+{
+    int rows_per_line = mono_ ? 8 : 1;
+    size_t stride = LineBytes(width_);
+    size_t line_bytes = LineBytes(r.Width());
+    size_t x_offset = mono_ ? (size_t)r.x0 : (size_t)r.x0 * pixel_bytes_;
+    const uint8_t* src = framebuffer + (size_t)(r.y0 / rows_per_line) * stride + x_offset;
+
+    // 整行宽窗口在帧缓冲中连续, 无需拷贝
+    if (r.x0 == 0 && r.x1 == width_)
+    {
+        last_.windows++;
+        last_.bytes += line_bytes * Lines(r.Height());
+        return display_.DrawBitmap(r.x0, r.y0, r.x1, r.y1, src);
+    }
+
+    int lines_per_band = (int)(scratch_bytes_ / line_bytes);
+    for (int line = 0; line < Lines(r.Height()); line += lines_per_band)
+    {
+        int lines = std::min(lines_per_band, Lines(r.Height()) - line);
+        for (int i = 0; i < lines; i++)
+        {
+            memcpy(scratch_ + i * line_bytes, src + (size_t)(line + i) * stride, line_bytes);
+        }
+        int y = r.y0 + line * rows_per_line;
+        if (!display_.DrawBitmap(r.x0, y, r.x1, y + lines * rows_per_line, scratch_))
+            return false;
+        // 暂存区在下一带复用前必须发送完毕
+        if (!display_.WaitColorDone())
+            return false;
+        last_.windows++;
+        last_.bytes += line_bytes * lines;
+    }
+    return true;
+}
+
+bool DirtyRegions::Flush(const void* framebuffer)
+{
+    if (scratch_ == nullptr)
+    {
+        logger_.Error("Not initialized");
+        return false;
+    }
+
+    Merge();
+    last_ = {};
+    last_.invalidated = invalidated_;
+
+    bool ok = true;
+    const uint8_t* fb = static_cast<const uint8_t*>(framebuffer);
+    for (size_t i = 0; i < count_ && ok; i++)
+    {
+        ok = FlushRect(rects_[i], fb);
+    }
+    // 直接引用帧缓冲的窗口也须发送完毕, 调用方才能开始绘制下一帧
+    if (ok && !display_.WaitColorDone())
+    {
+        ok = false;
+    }
+    if (!ok)
+    {
+        logger_.Error("Flush failed");
+    }
+    Clear();
+    return ok;
+}
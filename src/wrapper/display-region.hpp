@@ -0,0 +1,105 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "wrapper/display.hpp"
+#include "wrapper/logger.hpp"
+
+namespace wrapper
+{
+
+// 屏幕矩形, 右/下边界不含
+struct DisplayRect
+{
+    int x0;
+    int y0;
+    int x1;
+    int y1;
+
+    int Width() const { return x1 - x0; }
+    int Height() const { return y1 - y0; }
+    bool Empty() const { return x1 <= x0 || y1 <= y0; }
+};
+
+/**
+ * @brief 脏区累积与局部刷新
+ *
+ * 一帧内 Invalidate() 的矩形先被裁剪并累积, Flush() 时按代价模型合并后只发送必要的窗口:
+ * 单个窗口的代价 = 像素字节数 + 窗口命令开销 (CASET/RASET/RAMWR 或 SSD1306 页/列寻址),
+ * 两个矩形合并后的包围盒代价不高于分别发送时即合并. 矩形数超过 kMaxRects 时合并代价增量最小的一对.
+ *
+ * 帧缓冲格式: RGB 面板为行优先的整屏缓冲; 1 bpp 面板 (SSD1306) 为页格式, 每页 8 行,
+ * 每字节为一列的 8 个像素, 脏区在纵向对齐到页.
+ *
+ * 非整行宽的窗口先逐行拷贝到 DMA 暂存区再发送, 整行宽窗口直接引用帧缓冲.
+ */
+class DirtyRegions
+{
+   public:
+    static constexpr size_t kMaxRects = 16;
+
+    struct FlushStats
+    {
+        uint32_t invalidated;  // 本帧 Invalidate 调用次数
+        uint32_t windows;      // 实际发送的窗口数 (含暂存区不足导致的分带)
+        uint32_t bytes;        // 像素字节数
+    };
+
+    DirtyRegions(DisplayBase& display, Logger& logger);
+    ~DirtyRegions();
+
+    DirtyRegions(const DirtyRegions&) = delete;
+    DirtyRegions& operator=(const DirtyRegions&) = delete;
+
+    // scratch_bytes 至少容纳一整行 (1 bpp 为一整页)
+    bool Init(int width, int height, size_t scratch_bytes);
+    void Deinit();
+
+    // 每个窗口的命令开销, 折算为像素字节; 默认 SPI 面板 256, 1 bpp 面板 16
+    void SetWindowCost(size_t bytes) { window_cost_ = bytes; }
+
+    void Invalidate(int x0, int y0, int x1, int y1);
+    void InvalidateAll() { Invalidate(0, 0, width_, height_); }
+    void Clear();
+
+    size_t Count() const { return count_; }
+    const DisplayRect* Rects() const { return rects_; }
+
+    // 合并当前脏区并从 framebuffer 发送, 完成后清空
+    bool Flush(const void* framebuffer);
+    FlushStats GetLastFlush() const { return last_; }
+
+   private:
+    DisplayBase& display_;
+    Logger& logger_;
+    int width_;
+    int height_;
+    bool mono_;
+    size_t pixel_bytes_;
+    size_t window_cost_;
+    uint8_t* scratch_;
+    size_t scratch_bytes_;
+
+    DisplayRect rects_[kMaxRects];
+    size_t count_;
+    uint32_t invalidated_;
+    FlushStats last_;
+
+    // 一行 (1 bpp 为一页) 的字节数与行数
+    size_t LineBytes(int width) const
+    {
+        return mono_ ? (size_t)width : (size_t)width * pixel_bytes_;
+    }
+    int Lines(int height) const { return mono_ ? height / 8 : height; }
+    size_t Cost(const DisplayRect& r) const
+    {
+        return window_cost_ + LineBytes(r.Width()) * (size_t)Lines(r.Height());
+    }
+    static DisplayRect Bounds(const DisplayRect& a, const DisplayRect& b);
+
+    void Merge();
+    void MergeCheapestPair();
+    void Remove(size_t index);
+    bool FlushRect(const DisplayRect& r, const uint8_t* framebuffer);
+};
+
+}  // namespace wrapper
@@ -1,7 +1,775 @@
 #include "wrapper/display.hpp"
+#include "esp_attr.h"
+#include "esp_heap_caps.h"
+#include "esp_lcd_panel_commands.h"
+#include "esp_rom_sys.h"
+#include "wrapper/pixel.hpp"
+#include "esp_timer.h"
+#include <algorithm>
 
 using namespace wrapper;
 
+// --- Panel proxy ---
+
+namespace wrapper
+{
+
+struct PanelProxyOps
+{
+    static DisplayBase* Self(esp_lcd_panel_t* panel)
+    {
+        return static_cast<DisplayBase*>(panel->user_data);
+    }
+
+    static esp_err_t Reset(esp_lcd_panel_t* panel)
+    {
+        return esp_lcd_panel_reset(Self(panel)->panel_handle_);
+    }
+    static esp_err_t Init(esp_lcd_panel_t* panel)
+    {
+        return esp_lcd_panel_init(Self(panel)->panel_handle_);
+    }
+    // 代理不拥有底层面板, 由 Deinit() 负责删除
+    static esp_err_t Del(esp_lcd_panel_t*) { return ESP_OK; }
+    static esp_err_t DrawBitmap(
+        esp_lcd_panel_t* panel, int x_start, int y_start, int x_end, int y_end, const void* data)
+    {
+        return Self(panel)->DrawRegion(x_start, y_start, x_end, y_end, data);
+    }
+    // 软件旋转时只记录方向, 由 DrawTransformed 处理
+    static esp_err_t Mirror(esp_lcd_panel_t* panel, bool mirror_x, bool mirror_y)
+    {
+        DisplayBase* self = Self(panel);
+        if (self->xform_buffer_ != nullptr)
+        {
+            self->xform_mirror_x_ = mirror_x;
+            self->xform_mirror_y_ = mirror_y;
+            return ESP_OK;
+        }
+        return esp_lcd_panel_mirror(self->panel_handle_, mirror_x, mirror_y);
+    }
+    static esp_err_t SwapXY(esp_lcd_panel_t* panel, bool swap_axes)
+    {
+        DisplayBase* self = Self(panel);
+        if (self->xform_buffer_ != nullptr)
+        {
+            self->xform_swap_xy_ = swap_axes;
+            return ESP_OK;
+        }
+        return esp_lcd_panel_swap_xy(self->panel_handle_, swap_axes);
+    }
+    static esp_err_t SetGap(esp_lcd_panel_t* panel, int x_gap, int y_gap)
+    {
+        return esp_lcd_panel_set_gap(Self(panel)->panel_handle_, x_gap, y_gap);
+    }
+    static esp_err_t InvertColor(esp_lcd_panel_t* panel, bool invert)
+    {
+        return esp_lcd_panel_invert_color(Self(panel)->panel_handle_, invert);
+    }
+    static esp_err_t DispOnOff(esp_lcd_panel_t* panel, bool on_off)
+    {
+        return esp_lcd_panel_disp_on_off(Self(panel)->panel_handle_, on_off);
+    }
+    static esp_err_t DispSleep(esp_lcd_panel_t* panel, bool sleep)
+    {
+        return esp_lcd_panel_disp_sleep(Self(panel)->panel_handle_, sleep);
+    }
+};
+
+}  // namespace wrapper
+
+void DisplayBase::InstallProxy()
+{
+    if (proxy_installed_)
+        return;
+    proxy_ = {};
+    proxy_.reset = PanelProxyOps::Reset;
+    proxy_.init = PanelProxyOps::Init;
+    proxy_.del = PanelProxyOps::Del;
+    proxy_.draw_bitmap = PanelProxyOps::DrawBitmap;
+    proxy_.mirror = PanelProxyOps::Mirror;
+    proxy_.swap_xy = PanelProxyOps::SwapXY;
+    proxy_.set_gap = PanelProxyOps::SetGap;
+    proxy_.invert_color = PanelProxyOps::InvertColor;
+    proxy_.disp_on_off = PanelProxyOps::DispOnOff;
+    proxy_.disp_sleep = PanelProxyOps::DispSleep;
+    proxy_.user_data = this;
+    proxy_installed_ = true;
+}
+
+esp_err_t DisplayBase::DrawRegion(
+    int x_start, int y_start, int x_end, int y_end, const void* color_data)
+{
+    bool transform =
+        xform_buffer_ != nullptr && (xform_swap_xy_ || xform_mirror_x_ || xform_mirror_y_);
+    // 除直通外的路径都在返回前等待传输完成, 耗时即传输时间
+    bool swap = swap_buffer_ != nullptr && !transform;
+    bool synchronous = transform || swap || te_sem_ != nullptr || slice_bytes_ > 0;
+    int64_t start = esp_timer_get_time();
+
+    esp_err_t err = ESP_OK;
+    if (transform)
+        err = DrawTransformed(x_start, y_start, x_end, y_end, color_data);
+    else if (swap)
+        err = DrawSwapped(x_start, y_start, x_end, y_end, color_data);
+    else
+        err = DrawPhysical(x_start, y_start, x_end, y_end, color_data);
+    if (err == ESP_OK)
+    {
+        frame_metrics_.Add(FrameMetrics::kBytes,
+                           (uint32_t)((x_end - x_start) * (y_end - y_start) * bits_per_pixel_ / 8));
+        if (synchronous && bits_per_pixel_ >= 8)
+        {
+            frame_metrics_.Add(FrameMetrics::kDmaUs, (uint32_t)(esp_timer_get_time() - start));
+        }
+    }
+    return err;
+}
+
+esp_err_t DisplayBase::DrawPhysical(
+    int x_start, int y_start, int x_end, int y_end, const void* color_data)
+{
+    if (te_sem_ != nullptr && bits_per_pixel_ >= 8)
+    {
+        return DrawSynced(x_start, y_start, x_end, y_end, color_data);
+    }
+
+    // 1 bpp 面板按页组织数据, 不能按行切分
+    size_t row_bytes = (size_t)(x_end - x_start) * ((bits_per_pixel_ + 7) / 8);
+    if (slice_bytes_ == 0 || bits_per_pixel_ < 8 || row_bytes == 0)
+    {
+        return esp_lcd_panel_draw_bitmap(panel_handle_, x_start, y_start, x_end, y_end,
+                                         color_data);
+    }
+
+    int rows = (int)std::max<size_t>(1, slice_bytes_ / row_bytes);
+    const uint8_t* data = static_cast<const uint8_t*>(color_data);
+    for (int y = y_start; y < y_end; y += rows)
+    {
+        int y_stop = std::min(y + rows, y_end);
+        size_t bytes = (size_t)(y_stop - y) * row_bytes;
+        if (arbiter_ != nullptr && !arbiter_->Acquire(arbiter_client_, -1))
+        {
+            return ESP_ERR_TIMEOUT;
+        }
+        esp_err_t err = esp_lcd_panel_draw_bitmap(panel_handle_, x_start, y, x_end, y_stop, data);
+        // draw_bitmap 只把颜色数据排入 DMA 队列, 须等该片传输完成才能把总线让给下一个客户端
+        if (err == ESP_OK && !WaitColorDone())
+        {
+            err = ESP_FAIL;
+        }
+        if (arbiter_ != nullptr)
+        {
+            arbiter_->Release(arbiter_client_, bytes);
+        }
+        if (err != ESP_OK)
+        {
+            return err;
+        }
+        data += bytes;
+    }
+    return ESP_OK;
+}
+
+// --- Software rotation ---
+
+bool DisplayBase::EnableSoftwareRotation(int width, int height, size_t scratch_bytes)
+{
+    DisableSoftwareRotation();
+    size_t pixel_bytes = (bits_per_pixel_ + 7) / 8;
+    if (pixel_bytes != 2 && pixel_bytes != 3)
+    {
+        logger_.Error("Software rotation needs 16/24 bpp, got %u", (unsigned)bits_per_pixel_);
+        return false;
+    }
+    // 旋转后一行可能是原来的一列, 按长边计算
+    size_t min_bytes = (size_t)std::max(width, height) * pixel_bytes;
+    if (width <= 0 || height <= 0 || scratch_bytes < min_bytes)
+    {
+        logger_.Error("Invalid software rotation config: %dx%d, %u bytes", width, height,
+                      (unsigned)scratch_bytes);
+        return false;
+    }
+
+    xform_buffer_ = static_cast<uint8_t*>(heap_caps_malloc(scratch_bytes, MALLOC_CAP_DMA));
+    if (xform_buffer_ == nullptr)
+    {
+        logger_.Error("Failed to allocate %u byte rotation buffer", (unsigned)scratch_bytes);
+        return false;
+    }
+    xform_bytes_ = scratch_bytes;
+    xform_width_ = width;
+    xform_height_ = height;
+    xform_swap_xy_ = false;
+    xform_mirror_x_ = false;
+    xform_mirror_y_ = false;
+    // 面板回到原生方向, 之后的旋转全部由软件完成
+    esp_lcd_panel_swap_xy(panel_handle_, false);
+    esp_lcd_panel_mirror(panel_handle_, false, false);
+    InstallProxy();
+    logger_.Info("Software rotation enabled: %dx%d, %u byte buffer", width, height,
+                 (unsigned)scratch_bytes);
+    return true;
+}
+
+void DisplayBase::DisableSoftwareRotation()
+{
+    if (xform_buffer_ == nullptr)
+        return;
+    heap_caps_free(xform_buffer_);
+    xform_buffer_ = nullptr;
+    xform_bytes_ = 0;
+}
+
+void DisplayBase::MapToLogical(int* x, int* y) const
+{
+    if (xform_buffer_ == nullptr)
+        return;
+    int u = xform_mirror_x_ ? xform_width_ - 1 - *x : *x;
+    int v = xform_mirror_y_ ? xform_height_ - 1 - *y : *y;
+    *x = xform_swap_xy_ ? v : u;
+    *y = xform_swap_xy_ ? u : v;
+}
+
+bool DisplayBase::EnableByteSwap(size_t scratch_bytes)
+{
+    DisableByteSwap();
+    if (bits_per_pixel_ != 16 || scratch_bytes < sizeof(uint16_t))
+    {
+        logger_.Error("Invalid byte swap config: %u bpp, %u bytes", (unsigned)bits_per_pixel_,
+                      (unsigned)scratch_bytes);
+        return false;
+    }
+    swap_buffer_ = static_cast<uint8_t*>(heap_caps_malloc(scratch_bytes, MALLOC_CAP_DMA));
+    if (swap_buffer_ == nullptr)
+    {
+        logger_.Error("Failed to allocate %u byte swap buffer", (unsigned)scratch_bytes);
+        return false;
+    }
+    swap_bytes_ = scratch_bytes;
+    InstallProxy();
+    return true;
+}
+
+void DisplayBase::DisableByteSwap()
+{
+    if (swap_buffer_ == nullptr)
+        return;
+    heap_caps_free(swap_buffer_);
+    swap_buffer_ = nullptr;
+    swap_bytes_ = 0;
+}
+
+esp_err_t DisplayBase::DrawSwapped(
+    int x_start, int y_start, int x_end, int y_end, const void* color_data)
+{
+    size_t width = (size_t)(x_end - x_start);
+    size_t row_bytes = width * sizeof(uint16_t);
+    if (row_bytes > swap_bytes_)
+    {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    int band = (int)(swap_bytes_ / row_bytes);
+    const uint16_t* src = static_cast<const uint16_t*>(color_data);
+    uint16_t* dst = reinterpret_cast<uint16_t*>(swap_buffer_);
+    for (int y = y_start; y < y_end; y += band)
+    {
+        int rows = std::min(band, y_end - y);
+        PixelOps::SwapRgb565(dst, src, width * rows);
+        esp_err_t err = DrawPhysical(x_start, y, x_end, y + rows, dst);
+        // 暂存区在下一带交换前必须发送完毕
+        if (err == ESP_OK && !WaitColorDone())
+        {
+            err = ESP_FAIL;
+        }
+        if (err != ESP_OK)
+        {
+            return err;
+        }
+        src += width * rows;
+    }
+    return ESP_OK;
+}
+
+esp_err_t DisplayBase::DrawTransformed(
+    int x_start, int y_start, int x_end, int y_end, const void* color_data)
+{
+    size_t pixel_bytes = (bits_per_pixel_ + 7) / 8;
+    int width = x_end - x_start;
+    size_t row_bytes = (size_t)width * pixel_bytes;
+    if (row_bytes > xform_bytes_)
+    {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    int band = (int)(xform_bytes_ / row_bytes);
+    const uint8_t* src = static_cast<const uint8_t*>(color_data);
+    for (int y = y_start; y < y_end; y += band)
+    {
+        int rows = std::min(band, y_end - y);
+        if (pixel_bytes == 2)
+        {
+            PixelOps::Transform16(reinterpret_cast<uint16_t*>(xform_buffer_),
+                                  reinterpret_cast<const uint16_t*>(src), width, rows,
+                                  xform_swap_xy_, xform_mirror_x_, xform_mirror_y_);
+            if (swap_buffer_ != nullptr)
+            {
+                uint16_t* pixels = reinterpret_cast<uint16_t*>(xform_buffer_);
+                PixelOps::SwapRgb565(pixels, pixels, (size_t)width * rows);
+            }
+        }
+        else
+        {
+            PixelOps::Transform24(xform_buffer_, src, width, rows, xform_swap_xy_,
+                                  xform_mirror_x_, xform_mirror_y_);
+        }
+
+        // 逻辑矩形 -> 面板物理矩形: 先交换轴, 再在物理分辨率内镜像
+        int u0 = xform_swap_xy_ ? y : x_start;
+        int u1 = xform_swap_xy_ ? y + rows : x_end;
+        int v0 = xform_swap_xy_ ? x_start : y;
+        int v1 = xform_swap_xy_ ? x_end : y + rows;
+        if (xform_mirror_x_)
+        {
+            std::swap(u0, u1);
+            u0 = xform_width_ - u0;
+            u1 = xform_width_ - u1;
+        }
+        if (xform_mirror_y_)
+        {
+            std::swap(v0, v1);
+            v0 = xform_height_ - v0;
+            v1 = xform_height_ - v1;
+        }
+
+        esp_err_t err = DrawPhysical(u0, v0, u1, v1, xform_buffer_);
+        // 暂存区在下一带变换前必须发送完毕
+        if (err == ESP_OK && !WaitColorDone())
+        {
+            err = ESP_FAIL;
+        }
+        if (err != ESP_OK)
+        {
+            return err;
+        }
+        src += (size_t)rows * row_bytes;
+    }
+    return ESP_OK;
+}
+
+// --- Tearing effect sync ---
+
+void IRAM_ATTR DisplayBase::OnTearingEdge(void* arg)
+{
+    DisplayBase* self = static_cast<DisplayBase*>(arg);
+    int64_t now = esp_timer_get_time();
+    BaseType_t woken = pdFALSE;
+
+    taskENTER_CRITICAL_ISR(&self->te_lock_);
+    DisplayVsyncStats& stats = self->vsync_stats_;
+    if (self->te_last_us_ != 0)
+    {
+        uint32_t period = (uint32_t)(now - self->te_last_us_);
+        if (stats.period_us == 0)
+        {
+            stats.period_us = period;
+        }
+        else if (period < stats.period_us + stats.period_us / 2)
+        {
+            // 超过 1.5 倍周期视为漏掉了沿, 不计入周期与抖动
+            int32_t dev = (int32_t)period - (int32_t)stats.period_us;
+            uint32_t jitter = (uint32_t)(dev < 0 ? -dev : dev);
+            stats.period_us = (uint32_t)((int32_t)stats.period_us + dev / 8);
+            stats.jitter_us = (uint32_t)((int32_t)stats.jitter_us +
+                                         ((int32_t)jitter - (int32_t)stats.jitter_us) / 8);
+            if (jitter > stats.max_jitter_us)
+                stats.max_jitter_us = jitter;
+        }
+    }
+    self->te_last_us_ = now;
+    stats.vsyncs++;
+    taskEXIT_CRITICAL_ISR(&self->te_lock_);
+
+    xSemaphoreGiveFromISR(self->te_sem_, &woken);
+    if (woken == pdTRUE)
+        portYIELD_FROM_ISR();
+}
+
+int64_t DisplayBase::WaitVsync()
+{
+    uint32_t period = GetVsyncStats().period_us;
+    // 丢弃之前积累的沿, 只认调用之后的下一个
+    xSemaphoreTake(te_sem_, 0);
+    TickType_t ticks = pdMS_TO_TICKS(period != 0 ? period * 2 / 1000 + 1 : 50) + 1;
+    if (xSemaphoreTake(te_sem_, ticks) != pdTRUE)
+        return 0;
+    taskENTER_CRITICAL(&te_lock_);
+    int64_t edge = te_last_us_;
+    taskEXIT_CRITICAL(&te_lock_);
+    return edge;
+}
+
+void DisplayBase::OnDelayTimer(void* arg)
+{
+    xSemaphoreGive(static_cast<DisplayBase*>(arg)->te_delay_sem_);
+}
+
+void DisplayBase::DelayUntil(int64_t target_us)
+{
+    // 阻塞到起点前 kDelaySpinUs, 剩余的几十微秒忙等, 吸收 esp_timer 任务的调度延迟
+    int64_t sleep_us = target_us - kDelaySpinUs - esp_timer_get_time();
+    if (sleep_us > 0 && te_timer_ != nullptr)
+    {
+        xSemaphoreTake(te_delay_sem_, 0);
+        if (esp_timer_start_once(te_timer_, (uint64_t)sleep_us) == ESP_OK)
+        {
+            TickType_t ticks = pdMS_TO_TICKS((uint32_t)(sleep_us / 1000)) + 2;
+            if (xSemaphoreTake(te_delay_sem_, ticks) != pdTRUE)
+            {
+                esp_timer_stop(te_timer_);
+            }
+        }
+    }
+    int64_t remain = target_us - esp_timer_get_time();
+    if (remain > 0)
+    {
+        esp_rom_delay_us((uint32_t)remain);
+    }
+}
+
+esp_err_t DisplayBase::DrawSynced(
+    int x_start, int y_start, int x_end, int y_end, const void* color_data)
+{
+    size_t row_bytes = (size_t)(x_end - x_start) * ((bits_per_pixel_ + 7) / 8);
+    const uint8_t* data = static_cast<const uint8_t*>(color_data);
+
+    int y = y_start;
+    while (y < y_end)
+    {
+        int64_t edge = WaitVsync();
+        uint32_t period = GetVsyncStats().period_us;
+        if (edge == 0 || period == 0)
+        {
+            taskENTER_CRITICAL(&te_lock_);
+            vsync_stats_.timeouts++;
+            taskEXIT_CRITICAL(&te_lock_);
+        }
+
+        // 时间单位 ns: line 为扫描一行, write 为写入一行
+        int rows = y_end - y;
+        int64_t start = edge;
+        int64_t deadline = 0;
+        if (edge != 0 && period != 0 && te_scan_lines_ > 0)
+        {
+            uint64_t line_ns = (uint64_t)period * 1000 / te_scan_lines_;
+            uint64_t write_ns = (uint64_t)row_bytes * te_ns_per_byte_;
+            if (write_ns > line_ns)
+            {
+                // 扫描线越过起始行后开始, 写指针在下一帧扫描线追上前到达片尾; 留 10% 余量
+                uint64_t budget = (uint64_t)period * 900;
+                rows = std::min(rows, std::max(1, (int)(budget / (write_ns - line_ns))));
+                start = edge + (int64_t)(y * line_ns / 1000);
+                deadline = edge + period + (int64_t)((y + rows) * line_ns / 1000);
+            }
+            else
+            {
+                // 写入快于扫描: 消隐期开始写, 须在扫描线到达片尾前写完
+                deadline = edge + (int64_t)((y + rows) * line_ns / 1000);
+            }
+        }
+
+        int y_stop = y + rows;
+        size_t bytes = (size_t)rows * row_bytes;
+        if (arbiter_ != nullptr && !arbiter_->Acquire(arbiter_client_, -1))
+        {
+            return ESP_ERR_TIMEOUT;
+        }
+        if (start != 0)
+        {
+            DelayUntil(start);
+        }
+        int64_t begin = esp_timer_get_time();
+        esp_err_t err = esp_lcd_panel_draw_bitmap(panel_handle_, x_start, y, x_end, y_stop, data);
+        if (err == ESP_OK && !WaitColorDone())
+        {
+            err = ESP_FAIL;
+        }
+        int64_t done = esp_timer_get_time();
+        if (arbiter_ != nullptr)
+        {
+            arbiter_->Release(arbiter_client_, bytes);
+        }
+        if (err != ESP_OK)
+        {
+            return err;
+        }
+
+        // 以实测速率修正下一片的拆分 (含命令与调度开销)
+        uint32_t ns_per_byte = (uint32_t)((done - begin) * 1000 / (int64_t)bytes);
+        te_ns_per_byte_ += ((int32_t)ns_per_byte - (int32_t)te_ns_per_byte_) / 4;
+        taskENTER_CRITICAL(&te_lock_);
+        vsync_stats_.bands++;
+        if (deadline != 0 && done > deadline)
+            vsync_stats_.missed++;
+        taskEXIT_CRITICAL(&te_lock_);
+
+        data += bytes;
+        y = y_stop;
+    }
+    return ESP_OK;
+}
+
+DisplayVsyncStats DisplayBase::GetVsyncStats() const
+{
+    taskENTER_CRITICAL(&te_lock_);
+    DisplayVsyncStats stats = vsync_stats_;
+    taskEXIT_CRITICAL(&te_lock_);
+    return stats;
+}
+
+void DisplayBase::ResetVsyncStats()
+{
+    taskENTER_CRITICAL(&te_lock_);
+    // 周期是同步所需的状态, 保留
+    uint32_t period = vsync_stats_.period_us;
+    vsync_stats_ = {};
+    vsync_stats_.period_us = period;
+    taskEXIT_CRITICAL(&te_lock_);
+}
+
+// --- Async flush ---
+
+bool DisplayBase::InitAsyncFlush(size_t count, size_t buffer_bytes)
+{
+    DeinitAsyncFlush();
+    if (io_handle_ == nullptr || panel_handle_ == nullptr)
+    {
+        logger_.Error("Cannot init async flush: Not initialized");
+        return false;
+    }
+    if (count < 2 || count > kMaxFlushBuffers || buffer_bytes == 0)
+    {
+        logger_.Error("Invalid async flush config: %u x %u bytes", (unsigned)count,
+                      (unsigned)buffer_bytes);
+        return false;
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        flush_buffers_[i] = static_cast<uint8_t*>(heap_caps_malloc(buffer_bytes, MALLOC_CAP_DMA));
+        if (flush_buffers_[i] == nullptr)
+        {
+            logger_.Error("Failed to allocate flush buffer %u (%u bytes)", (unsigned)i,
+                          (unsigned)buffer_bytes);
+            flush_buffer_count_ = i;
+            DeinitAsyncFlush();
+            return false;
+        }
+        flush_free_[i] = true;
+    }
+    flush_buffer_count_ = count;
+    flush_buffer_bytes_ = buffer_bytes;
+    in_flight_head_ = 0;
+    in_flight_count_ = 0;
+    last_submit_us_ = 0;
+    flush_stats_ = {};
+    flush_sem_ = xSemaphoreCreateCountingStatic(count, count, &flush_sem_buffer_);
+
+    esp_lcd_panel_io_callbacks_t cbs = {};
+    cbs.on_color_trans_done = OnColorTransDone;
+    esp_err_t err = esp_lcd_panel_io_register_event_callbacks(io_handle_, &cbs, this);
+    if (err != ESP_OK)
+    {
+        logger_.Error("Failed to register trans done callback: %s", esp_err_to_name(err));
+        DeinitAsyncFlush();
+        return false;
+    }
+    logger_.Info("Async flush: %u x %u byte buffers", (unsigned)count, (unsigned)buffer_bytes);
+    return true;
+}
+
+void DisplayBase::DeinitAsyncFlush()
+{
+    if (flush_buffer_count_ == 0 && flush_buffers_[0] == nullptr)
+        return;
+    if (flush_sem_ != nullptr)
+    {
+        WaitFlushIdle(-1);
+        // 恢复配置中的回调, 面板 IO 可继续被同步路径或 LVGL 使用
+        if (io_handle_ != nullptr)
+        {
+            esp_lcd_panel_io_callbacks_t cbs = {};
+            cbs.on_color_trans_done = user_trans_done_;
+            esp_lcd_panel_io_register_event_callbacks(io_handle_, &cbs, user_trans_ctx_);
+        }
+        vSemaphoreDelete(flush_sem_);
+        flush_sem_ = nullptr;
+    }
+    for (size_t i = 0; i < kMaxFlushBuffers; i++)
+    {
+        heap_caps_free(flush_buffers_[i]);
+        flush_buffers_[i] = nullptr;
+        flush_free_[i] = false;
+    }
+    flush_buffer_count_ = 0;
+    flush_buffer_bytes_ = 0;
+}
+
+uint8_t* DisplayBase::AcquireFlushBuffer(int timeout_ms)
+{
+    if (flush_sem_ == nullptr)
+        return nullptr;
+
+    int64_t start = esp_timer_get_time();
+    TickType_t ticks = timeout_ms < 0 ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms);
+    if (xSemaphoreTake(flush_sem_, ticks) != pdTRUE)
+        return nullptr;
+    uint32_t wait_us = (uint32_t)(esp_timer_get_time() - start);
+
+    uint8_t* buffer = nullptr;
+    taskENTER_CRITICAL(&flush_lock_);
+    for (size_t i = 0; i < flush_buffer_count_; i++)
+    {
+        if (flush_free_[i])
+        {
+            flush_free_[i] = false;
+            buffer = flush_buffers_[i];
+            break;
+        }
+    }
+    flush_stats_.total_wait_us += wait_us;
+    if (wait_us > flush_stats_.max_wait_us)
+        flush_stats_.max_wait_us = wait_us;
+    taskEXIT_CRITICAL(&flush_lock_);
+    frame_metrics_.Add(FrameMetrics::kFlushWaitUs, wait_us);
+    return buffer;
+}
+
+bool DisplayBase::DrawBitmapAsync(int x_start, int y_start, int x_end, int y_end, uint8_t* buffer)
+{
+    size_t index = 0;
+    while (index < flush_buffer_count_ && flush_buffers_[index] != buffer)
+        index++;
+    if (index == flush_buffer_count_)
+    {
+        logger_.Error("Buffer %p is not an async flush buffer", buffer);
+        return false;
+    }
+
+    size_t bytes = (size_t)(x_end - x_start) * (size_t)(y_end - y_start) * bits_per_pixel_ / 8;
+    int64_t now = esp_timer_get_time();
+
+    // 先入队再提交: 完成回调可能早于 draw_bitmap 返回
+    taskENTER_CRITICAL(&flush_lock_);
+    size_t tail = (in_flight_head_ + in_flight_count_) % kMaxFlushBuffers;
+    in_flight_[tail] = (uint8_t)index;
+    in_flight_submit_us_[tail] = now;
+    in_flight_count_++;
+    if (last_submit_us_ != 0)
+        flush_stats_.last_interval_us = (uint32_t)(now - last_submit_us_);
+    last_submit_us_ = now;
+    flush_stats_.bytes += bytes;
+    taskEXIT_CRITICAL(&flush_lock_);
+
+    // 底层面板的 draw_bitmap 先以 tx_param 写窗口, 这会等待上一帧颜色传输结束;
+    // 随后颜色数据排入 DMA 队列即返回
+    esp_err_t err =
+        esp_lcd_panel_draw_bitmap(panel_handle_, x_start, y_start, x_end, y_end, buffer);
+    if (err != ESP_OK)
+    {
+        taskENTER_CRITICAL(&flush_lock_);
+        in_flight_count_--;
+        flush_free_[index] = true;
+        flush_stats_.errors++;
+        flush_stats_.bytes -= bytes;
+        taskEXIT_CRITICAL(&flush_lock_);
+        xSemaphoreGive(flush_sem_);
+        logger_.Error("Async draw failed: %s", esp_err_to_name(err));
+        return false;
+    }
+    frame_metrics_.Add(FrameMetrics::kBytes, (uint32_t)bytes);
+    return true;
+}
+
+bool DisplayBase::WaitFlushIdle(int timeout_ms)
+{
+    if (flush_sem_ == nullptr)
+        return true;
+    // 取走全部空闲计数即表示没有在途缓冲, 随后原样归还
+    TickType_t ticks = timeout_ms < 0 ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms);
+    size_t taken = 0;
+    while (taken < flush_buffer_count_ && xSemaphoreTake(flush_sem_, ticks) == pdTRUE)
+    {
+        taken++;
+    }
+    for (size_t i = 0; i < taken; i++)
+    {
+        xSemaphoreGive(flush_sem_);
+    }
+    return taken == flush_buffer_count_;
+}
+
+bool IRAM_ATTR DisplayBase::OnColorTransDone(esp_lcd_panel_io_handle_t io,
+                                             esp_lcd_panel_io_event_data_t* edata,
+                                             void* user_ctx)
+{
+    DisplayBase* self = static_cast<DisplayBase*>(user_ctx);
+    BaseType_t woken = pdFALSE;
+    int64_t now = esp_timer_get_time();
+
+    taskENTER_CRITICAL_ISR(&self->flush_lock_);
+    if (self->in_flight_count_ > 0)
+    {
+        size_t head = self->in_flight_head_;
+        // 传输在上一帧完成后才真正开始
+        int64_t start = self->in_flight_submit_us_[head];
+        if (self->last_done_us_ > start)
+            start = self->last_done_us_;
+        uint32_t dma_us = (uint32_t)(now - start);
+        self->flush_free_[self->in_flight_[head]] = true;
+        self->in_flight_head_ = (head + 1) % kMaxFlushBuffers;
+        self->in_flight_count_--;
+        self->last_done_us_ = now;
+        self->flush_stats_.frames++;
+        self->flush_stats_.total_dma_us += dma_us;
+        if (dma_us > self->flush_stats_.max_dma_us)
+            self->flush_stats_.max_dma_us = dma_us;
+        taskEXIT_CRITICAL_ISR(&self->flush_lock_);
+        self->frame_metrics_.AddFromIsr(FrameMetrics::kDmaUs, dma_us);
+        self->frame_metrics_.CountFrameFromIsr(0);
+        xSemaphoreGiveFromISR(self->flush_sem_, &woken);
+    }
+    else
+    {
+        taskEXIT_CRITICAL_ISR(&self->flush_lock_);
+    }
+
+    bool user_woken = false;
+    if (self->user_trans_done_ != nullptr)
+    {
+        user_woken = self->user_trans_done_(io, edata, self->user_trans_ctx_);
+    }
+    return woken == pdTRUE || user_woken;
+}
+
+DisplayFlushStats DisplayBase::GetFlushStats() const
+{
+    taskENTER_CRITICAL(&flush_lock_);
+    DisplayFlushStats stats = flush_stats_;
+    taskEXIT_CRITICAL(&flush_lock_);
+    return stats;
+}
+
+void DisplayBase::ResetFlushStats()
+{
+    taskENTER_CRITICAL(&flush_lock_);
+    flush_stats_ = {};
+    taskEXIT_CRITICAL(&flush_lock_);
+}
+
+// --- I2cDisplay ---
+
 bool I2cDisplay::InitIo(const I2cBus& bus, const I2cDisplayConfig& config)
 {
     if (io_handle_ != nullptr)
@@ -72,6 +840,9 @@ bool I2cDisplay::Init(
     if (!InitIo(bus, config))
         return false;
 
+    bits_per_pixel_ = config.panel_config.bits_per_pixel;
+    user_trans_done_ = config.io_config.on_color_trans_done;
+    user_trans_ctx_ = config.io_config.user_ctx;
     esp_err_t err = new_panel_func(io_handle_, &config.panel_config, &panel_handle_);
     if (err != ESP_OK)
     {
@@ -84,6 +855,9 @@ bool I2cDisplay::Init(
 
 bool I2cDisplay::Deinit()
 {
+    DeinitAsyncFlush();
+    DisableSoftwareRotation();
+    proxy_installed_ = false;
     if (panel_handle_ != nullptr)
     {
         if (esp_lcd_panel_del(panel_handle_) != ESP_OK)
@@ -106,6 +880,8 @@ bool I2cDisplay::Deinit()
     return true;
 }
 
+// --- SpiDisplay ---
+
 bool SpiDisplay::InitIo(const SpiBus& bus, const SpiDisplayConfig& config)
 {
     if (io_handle_ != nullptr)
@@ -169,22 +945,161 @@ bool SpiDisplay::Init(
                             const esp_lcd_panel_dev_config_t*,
                             esp_lcd_panel_handle_t*)> new_panel_func,
     std::function<esp_err_t(const esp_lcd_panel_io_handle_t)> custom_init_panel_func)
+{
+    if (!CreatePanel(bus, config, new_panel_func))
+        return false;
+
+    return InitPanel(config, custom_init_panel_func);
+}
+
+bool SpiDisplay::CreatePanel(
+    const SpiBus& bus,
+    const SpiDisplayConfig& config,
+    std::function<esp_err_t(const esp_lcd_panel_io_handle_t,
+                            const esp_lcd_panel_dev_config_t*,
+                            esp_lcd_panel_handle_t*)> new_panel_func)
 {
     if (!InitIo(bus, config))
         return false;
 
+    bits_per_pixel_ = config.panel_config.bits_per_pixel;
+    user_trans_done_ = config.io_config.on_color_trans_done;
+    user_trans_ctx_ = config.io_config.user_ctx;
+    pclk_hz_ = config.io_config.pclk_hz;
+    queued_io_ = true;
     esp_err_t err = new_panel_func(io_handle_, &config.panel_config, &panel_handle_);
     if (err != ESP_OK)
     {
         logger_.Error("Failed to create new panel: %s", esp_err_to_name(err));
         return false;
     }
+    return true;
+}
 
-    return InitPanel(config, custom_init_panel_func);
+void SpiDisplay::EnableSlicing(size_t max_slice_bytes, SpiArbiter* arbiter, int client)
+{
+    slice_bytes_ = max_slice_bytes;
+    arbiter_ = max_slice_bytes > 0 ? arbiter : nullptr;
+    arbiter_client_ = client;
+    if (max_slice_bytes > 0)
+    {
+        InstallProxy();
+        logger_.Info("Slicing enabled: %u bytes per slice%s", (unsigned)max_slice_bytes,
+                     arbiter_ != nullptr ? ", arbitrated" : "");
+    }
+}
+
+bool SpiDisplay::EnableTearingSync(gpio_num_t te_gpio, int scan_lines)
+{
+    DisableTearingSync();
+    if (io_handle_ == nullptr || panel_handle_ == nullptr)
+    {
+        logger_.Error("Cannot enable tearing sync: Not initialized");
+        return false;
+    }
+    if (te_gpio == GPIO_NUM_NC || scan_lines < 0)
+    {
+        logger_.Error("Invalid tearing sync config: GPIO %d, %d lines", te_gpio, scan_lines);
+        return false;
+    }
+
+    gpio_config_t te_cfg = {};
+    te_cfg.pin_bit_mask = 1ULL << te_gpio;
+    te_cfg.mode = GPIO_MODE_INPUT;
+    te_cfg.pull_up_en = GPIO_PULLUP_DISABLE;
+    te_cfg.pull_down_en = GPIO_PULLDOWN_DISABLE;
+    te_cfg.intr_type = GPIO_INTR_POSEDGE;
+    if (gpio_config(&te_cfg) != ESP_OK)
+    {
+        logger_.Error("Failed to configure TE GPIO %d", te_gpio);
+        return false;
+    }
+    // 若已安装则忽略 ESP_ERR_INVALID_STATE
+    esp_err_t err = gpio_install_isr_service(0);
+    if (err != ESP_OK && err != ESP_ERR_INVALID_STATE)
+    {
+        logger_.Error("Failed to install GPIO ISR service: %s", esp_err_to_name(err));
+        return false;
+    }
+
+    te_sem_ = xSemaphoreCreateBinaryStatic(&te_sem_buffer_);
+    te_delay_sem_ = xSemaphoreCreateBinaryStatic(&te_delay_buffer_);
+    esp_timer_create_args_t timer_args = {};
+    timer_args.callback = OnDelayTimer;
+    timer_args.arg = this;
+    timer_args.dispatch_method = ESP_TIMER_TASK;
+    timer_args.name = "te_delay";
+    err = esp_timer_create(&timer_args, &te_timer_);
+    if (err != ESP_OK)
+    {
+        logger_.Error("Failed to create TE delay timer: %s", esp_err_to_name(err));
+        DisableTearingSync();
+        return false;
+    }
+    te_gpio_ = te_gpio;
+    te_scan_lines_ = scan_lines;
+    te_last_us_ = 0;
+    vsync_stats_ = {};
+    // 初值按 SPI 时钟估算, 之后由实测修正
+    te_ns_per_byte_ = pclk_hz_ > 0 ? (uint32_t)(8000000000ULL / (uint64_t)pclk_hz_) : 200;
+
+    err = gpio_isr_handler_add(te_gpio, OnTearingEdge, this);
+    if (err != ESP_OK)
+    {
+        logger_.Error("Failed to add TE ISR handler: %s", esp_err_to_name(err));
+        DisableTearingSync();
+        return false;
+    }
+
+    // TE 模式 0: 仅在 V-blank 期间输出高电平
+    uint8_t te_mode = 0x00;
+    if (!IoTxParam(LCD_CMD_TEON, &te_mode, 1))
+    {
+        logger_.Error("Failed to send TEON");
+        DisableTearingSync();
+        return false;
+    }
+
+    InstallProxy();
+    logger_.Info("Tearing sync enabled: TE GPIO %d, %d scan lines", te_gpio, scan_lines);
+    return true;
+}
+
+void SpiDisplay::DisableTearingSync()
+{
+    if (te_gpio_ != GPIO_NUM_NC)
+    {
+        gpio_isr_handler_remove(te_gpio_);
+        if (io_handle_ != nullptr)
+        {
+            IoTxParam(LCD_CMD_TEOFF, nullptr, 0);
+        }
+        te_gpio_ = GPIO_NUM_NC;
+    }
+    if (te_timer_ != nullptr)
+    {
+        esp_timer_stop(te_timer_);
+        esp_timer_delete(te_timer_);
+        te_timer_ = nullptr;
+    }
+    if (te_delay_sem_ != nullptr)
+    {
+        vSemaphoreDelete(te_delay_sem_);
+        te_delay_sem_ = nullptr;
+    }
+    if (te_sem_ != nullptr)
+    {
+        vSemaphoreDelete(te_sem_);
+        te_sem_ = nullptr;
+    }
 }
 
 bool SpiDisplay::Deinit()
 {
+    DeinitAsyncFlush();
+    DisableTearingSync();
+    DisableSoftwareRotation();
+    proxy_installed_ = false;
     if (panel_handle_ != nullptr)
     {
         if (esp_lcd_panel_del(panel_handle_) != ESP_OK)
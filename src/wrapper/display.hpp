@@ -3,7 +3,12 @@
 #include "esp_lcd_panel_io.h"
 #include "esp_lcd_panel_dev.h"
 #include "esp_lcd_panel_ops.h"
+#include "esp_lcd_panel_interface.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
 
+#include "wrapper/frame-metrics.hpp"
 #include "wrapper/logger.hpp"
 #include "wrapper/i2c.hpp"
 #include "wrapper/spi.hpp"
@@ -128,12 +133,135 @@ struct SpiDisplayConfig
     }
 };
 
+// 异步刷新统计; dma_us 为单帧颜色传输耗时, wait_us 为渲染方在 AcquireFlushBuffer 中的阻塞时间
+struct DisplayFlushStats
+{
+    uint32_t frames = 0;
+    uint32_t errors = 0;
+    uint64_t bytes = 0;
+    uint64_t total_dma_us = 0;
+    uint32_t max_dma_us = 0;
+    uint64_t total_wait_us = 0;
+    uint32_t max_wait_us = 0;
+    uint32_t last_interval_us = 0;  // 相邻两次提交的间隔
+};
+
+// TE 同步统计; missed 为未能在扫描线追上前写完的片 (可能撕裂),
+// timeouts 为未等到 TE 沿而直接发送的片
+struct DisplayVsyncStats
+{
+    uint32_t vsyncs = 0;
+    uint32_t bands = 0;
+    uint32_t missed = 0;
+    uint32_t timeouts = 0;
+    uint32_t period_us = 0;  // 刷新周期 (滑动平均)
+    uint32_t jitter_us = 0;  // 周期偏差 (滑动平均)
+    uint32_t max_jitter_us = 0;
+};
+
+// 分步初始化的耗时: elapsed 为开始到完成, blocked 为最后阻塞等待的时间,
+// late 为重叠的其它工作使各步晚于最早时间执行的累计
+struct PanelInitTiming
+{
+    int64_t elapsed_us = 0;
+    int64_t blocked_us = 0;
+    int64_t late_us = 0;
+};
+
 class DisplayBase
 {
+    friend struct PanelProxyOps;
+
+   public:
+    static constexpr size_t kMaxFlushBuffers = 4;
+
    protected:
     esp_lcd_panel_io_handle_t io_handle_ = nullptr;
     esp_lcd_panel_handle_t panel_handle_ = nullptr;
     Logger& logger_;
+    uint32_t bits_per_pixel_ = 16;
+    bool queued_io_ = false;  // 颜色数据经 DMA 队列异步发送 (SPI 面板 IO)
+
+    // --- 面板代理 ---
+    // 安装后 GetPanelHandle() 返回代理句柄: draw_bitmap 经 DrawRegion() 处理, 其余操作直通
+    // panel_handle_. LVGL 等上层持有代理句柄, 因此分片等策略对其透明.
+    mutable esp_lcd_panel_t proxy_ = {};
+    bool proxy_installed_ = false;
+
+    // 分片刷新 (见 SpiDisplay::EnableSlicing)
+    size_t slice_bytes_ = 0;
+    SpiArbiter* arbiter_ = nullptr;
+    int arbiter_client_ = -1;
+
+    // TE 同步 (见 SpiDisplay::EnableTearingSync)
+    gpio_num_t te_gpio_ = GPIO_NUM_NC;
+    int te_scan_lines_ = 0;
+    uint32_t te_ns_per_byte_ = 0;  // 实测颜色传输速率
+    int64_t te_last_us_ = 0;
+    StaticSemaphore_t te_sem_buffer_;
+    SemaphoreHandle_t te_sem_ = nullptr;
+    mutable portMUX_TYPE te_lock_ = portMUX_INITIALIZER_UNLOCKED;
+    DisplayVsyncStats vsync_stats_;
+    // 片起点的定时唤醒: 单次定时器在起点前 kDelaySpinUs 释放信号量, 其余时间任务阻塞
+    static constexpr int64_t kDelaySpinUs = 50;
+    esp_timer_handle_t te_timer_ = nullptr;
+    StaticSemaphore_t te_delay_buffer_;
+    SemaphoreHandle_t te_delay_sem_ = nullptr;
+
+    // 软件旋转 (见 EnableSoftwareRotation)
+    uint8_t* xform_buffer_ = nullptr;
+    size_t xform_bytes_ = 0;
+    int xform_width_ = 0;  // 面板物理分辨率
+    int xform_height_ = 0;
+    bool xform_swap_xy_ = false;
+    bool xform_mirror_x_ = false;
+    bool xform_mirror_y_ = false;
+
+    // RGB565 字节交换 (见 EnableByteSwap)
+    uint8_t* swap_buffer_ = nullptr;
+    size_t swap_bytes_ = 0;
+
+    void InstallProxy();
+    // 代理的 draw_bitmap 入口: 字节交换 / 软件旋转 -> TE 同步 / 分片 -> 底层面板
+    esp_err_t DrawRegion(int x_start, int y_start, int x_end, int y_end, const void* color_data);
+    esp_err_t DrawTransformed(
+        int x_start, int y_start, int x_end, int y_end, const void* color_data);
+    esp_err_t DrawSwapped(int x_start, int y_start, int x_end, int y_end, const void* color_data);
+    esp_err_t DrawPhysical(int x_start, int y_start, int x_end, int y_end, const void* color_data);
+    esp_err_t DrawSynced(int x_start, int y_start, int x_end, int y_end, const void* color_data);
+    // 等待下一个 TE 沿, 返回其时间戳; 超时返回 0
+    int64_t WaitVsync();
+    void DelayUntil(int64_t target_us);
+
+    static void OnTearingEdge(void* arg);
+    static void OnDelayTimer(void* arg);
+
+    // --- 异步多缓冲刷新 ---
+    // 缓冲状态: 空闲 -> (AcquireFlushBuffer) 渲染中 -> (DrawBitmapAsync) 在途 -> (传输完成) 空闲.
+    // 颜色传输按提交顺序完成, 在途缓冲以 FIFO 记录, 完成回调弹出队首.
+    uint8_t* flush_buffers_[kMaxFlushBuffers] = {};
+    bool flush_free_[kMaxFlushBuffers] = {};
+    size_t flush_buffer_count_ = 0;
+    size_t flush_buffer_bytes_ = 0;
+    uint8_t in_flight_[kMaxFlushBuffers] = {};
+    int64_t in_flight_submit_us_[kMaxFlushBuffers] = {};
+    size_t in_flight_head_ = 0;
+    size_t in_flight_count_ = 0;
+    int64_t last_done_us_ = 0;
+    int64_t last_submit_us_ = 0;
+    StaticSemaphore_t flush_sem_buffer_;
+    SemaphoreHandle_t flush_sem_ = nullptr;  // 空闲缓冲计数
+    mutable portMUX_TYPE flush_lock_ = portMUX_INITIALIZER_UNLOCKED;
+    DisplayFlushStats flush_stats_;
+    FrameMetrics frame_metrics_;
+
+    // 配置中用户提供的完成回调, 由 OnColorTransDone 转发
+    esp_lcd_panel_io_color_trans_done_cb_t user_trans_done_ = nullptr;
+    void* user_trans_ctx_ = nullptr;
+
+    static bool OnColorTransDone(esp_lcd_panel_io_handle_t io,
+                                 esp_lcd_panel_io_event_data_t* edata,
+                                 void* user_ctx);
 
    public:
     DisplayBase(esp_lcd_panel_io_handle_t io_handle,
@@ -143,7 +271,12 @@ class DisplayBase
     {
     }
     DisplayBase(Logger& logger) : io_handle_(nullptr), panel_handle_(nullptr), logger_(logger) {}
-    ~DisplayBase() = default;
+    ~DisplayBase()
+    {
+        DeinitAsyncFlush();
+        DisableSoftwareRotation();
+        DisableByteSwap();
+    }
 
     Logger& GetLogger() { return logger_; }
 
@@ -158,24 +291,92 @@ class DisplayBase
         return esp_lcd_panel_io_tx_color(io_handle_, lcd_cmd, color, color_size) == ESP_OK;
     }
 
+    // 等待已排队的颜色传输全部完成, 之后才能复用 DrawBitmap 的源缓冲; 同步 IO 直接返回.
+    // 不带命令的 tx_param 会先取回所有在途颜色事务
+    bool WaitColorDone()
+    {
+        return !queued_io_ || esp_lcd_panel_io_tx_param(io_handle_, -1, nullptr, 0) == ESP_OK;
+    }
+
+    uint32_t GetBitsPerPixel() const { return bits_per_pixel_; }
+
+    DisplayVsyncStats GetVsyncStats() const;
+    void ResetVsyncStats();
+
+    /**
+     * @brief 以软件旋转/镜像代替面板 MADCTL
+     *
+     * 安装后代理句柄上的 swap_xy / mirror 不再下发到面板, 而是记录下来, 由 draw_bitmap
+     * 在发送前用 PixelOps::Transform16/24 把区域变换到面板物理坐标. 面板始终以原生方向
+     * 写入, 行方向与扫描方向一致, 可与 TE 同步配合. LVGL 侧使用 sw_rotate = false,
+     * 旋转经 esp_lcd_panel_swap_xy / mirror 到达代理.
+     *
+     * width、height 为面板物理分辨率; scratch_bytes 为 DMA 暂存区, 至少容纳一行,
+     * 较大区域按行带分批变换. 仅支持 16/24 位像素.
+     */
+    bool EnableSoftwareRotation(int width, int height, size_t scratch_bytes);
+    void DisableSoftwareRotation();
+    // 面板物理坐标 (如原生方向的触摸坐标) 转换为当前旋转下的逻辑坐标
+    void MapToLogical(int* x, int* y) const;
+
+    /**
+     * @brief 在面板代理中交换 RGB565 高低字节 (SPI 面板的大端线序), 代替 LVGL 的 swap_bytes
+     *
+     * 由 PixelOps::SwapRgb565 按行带交换到 scratch_bytes 的 DMA 暂存区后发送, 源缓冲不变,
+     * 可用于跨帧保留的帧缓冲 (DirtyRegions、LVGL full_refresh/direct_mode). 交换后的刷新
+     * 为同步完成. 软件旋转时直接在变换暂存区中交换. 仅支持 16 位像素, scratch_bytes 至少
+     * 容纳一行. 须在 LvglPort::AddDisplay() 之前调用.
+     */
+    bool EnableByteSwap(size_t scratch_bytes);
+    void DisableByteSwap();
+    bool GetByteSwap() const { return swap_buffer_ != nullptr; }
+
+    /**
+     * @brief 异步多缓冲刷新
+     *
+     * 预分配 count 块 DMA 缓冲 (2..kMaxFlushBuffers). 渲染方 AcquireFlushBuffer() 取得空闲缓冲,
+     * 填充后 DrawBitmapAsync() 提交并立即返回; 传输完成回调 (on_color_trans_done) 归还缓冲,
+     * 于是缓冲 N 发送期间可以渲染 N+1.
+     *
+     * @note 接管面板 IO 的完成回调 (配置中的 on_color_trans_done 仍会被转发), 因此不能与
+     *       LvglPort::AddDisplay 用于同一块屏. 异步路径绕过分片代理, 直接提交到底层面板.
+     *       面向不经 LVGL 的直接渲染; 板级代码目前都走 LVGL, 树内没有使用者.
+     *       LVGL 下由 esp_lvgl_port 的 double_buffer 提供同样的渲染/传输重叠.
+     */
+    bool InitAsyncFlush(size_t count, size_t buffer_bytes);
+    void DeinitAsyncFlush();
+    uint8_t* AcquireFlushBuffer(int timeout_ms);
+    // buffer 必须来自 AcquireFlushBuffer; 提交失败时缓冲直接归还
+    bool DrawBitmapAsync(int x_start, int y_start, int x_end, int y_end, uint8_t* buffer);
+    // 等待全部在途传输完成
+    bool WaitFlushIdle(int timeout_ms);
+    size_t GetFlushBufferBytes() const { return flush_buffer_bytes_; }
+    DisplayFlushStats GetFlushStats() const;
+    void ResetFlushStats();
+
+    // 最近若干次刷新的滚动统计: 字节数; 传输耗时 (异步路径及同步完成的代理刷新);
+    // 缓冲等待与帧数 (异步路径)
+    FrameMetricsSnapshot GetFrameMetrics() const { return frame_metrics_.Snapshot(); }
+    void ResetFrameMetrics() { frame_metrics_.Reset(); }
+
     // Panel operations
     bool Reset() { return esp_lcd_panel_reset(panel_handle_) == ESP_OK; }
     bool Init() { return esp_lcd_panel_init(panel_handle_) == ESP_OK; }
 
     bool DrawBitmap(int x_start, int y_start, int x_end, int y_end, const void* color_data)
     {
-        return esp_lcd_panel_draw_bitmap(panel_handle_, x_start, y_start, x_end, y_end,
+        return esp_lcd_panel_draw_bitmap(GetPanelHandle(), x_start, y_start, x_end, y_end,
                                          color_data) == ESP_OK;
     }
 
     bool Mirror(bool mirror_x, bool mirror_y)
     {
-        return esp_lcd_panel_mirror(panel_handle_, mirror_x, mirror_y) == ESP_OK;
+        return esp_lcd_panel_mirror(GetPanelHandle(), mirror_x, mirror_y) == ESP_OK;
     }
 
     bool SwapXY(bool swap_axes)
     {
-        return esp_lcd_panel_swap_xy(panel_handle_, swap_axes) == ESP_OK;
+        return esp_lcd_panel_swap_xy(GetPanelHandle(), swap_axes) == ESP_OK;
     }
 
     bool SetGap(int x_gap, int y_gap)
@@ -201,7 +402,10 @@ class DisplayBase
 
     // Handle getters
     esp_lcd_panel_io_handle_t GetIoHandle() const { return io_handle_; }
-    esp_lcd_panel_handle_t GetPanelHandle() const { return panel_handle_; }
+    esp_lcd_panel_handle_t GetPanelHandle() const
+    {
+        return proxy_installed_ ? &proxy_ : panel_handle_;
+    }
 };
 
 /**
@@ -237,11 +441,21 @@ class I2cDisplay : public DisplayBase
 class SpiDisplay : public DisplayBase
 {
    private:
+    int pclk_hz_ = 0;
+
     bool InitIo(const SpiBus& bus, const SpiDisplayConfig& config);
     bool InitPanel(
         const SpiDisplayConfig& config,
         std::function<esp_err_t(const esp_lcd_panel_io_handle_t)> custom_init_panel_func = nullptr);
 
+   protected:
+    // 只创建 IO 与面板, 不复位/初始化; 供分步初始化的驱动使用
+    bool CreatePanel(const SpiBus& bus,
+                     const SpiDisplayConfig& config,
+                     std::function<esp_err_t(const esp_lcd_panel_io_handle_t,
+                                             const esp_lcd_panel_dev_config_t*,
+                                             esp_lcd_panel_handle_t*)> new_panel_func);
+
    public:
     SpiDisplay(Logger& logger) : DisplayBase(nullptr, nullptr, logger) {}
 
@@ -255,6 +469,33 @@ class SpiDisplay : public DisplayBase
                                 esp_lcd_panel_handle_t*)> new_panel_func,
         std::function<esp_err_t(const esp_lcd_panel_io_handle_t)> custom_init_panel_func = nullptr);
     bool Deinit();
+
+    /**
+     * @brief 按行带分片刷新, 与共享总线上的其它设备交错
+     *
+     * 每次 draw_bitmap 拆为不超过 max_slice_bytes 的行带; 每片先向 arbiter 申请时间片,
+     * 等待该片 DMA 完成后释放, SD 卡/射频事务可在片间插入. 分片后的刷新为同步完成,
+     * on_color_trans_done 每片触发一次. arbiter 为空时仅分片. max_slice_bytes 为 0 关闭.
+     *
+     * @note 须在 LvglPort::AddDisplay() 之前调用, LVGL 才会拿到代理面板句柄.
+     */
+    void EnableSlicing(size_t max_slice_bytes, SpiArbiter* arbiter = nullptr, int client = -1);
+
+    /**
+     * @brief 按面板 TE 信号同步刷新, 消除撕裂
+     *
+     * 打开面板 TE 输出 (TEON, 仅 V-blank), 以 te_gpio 上升沿为帧起点. 每片刷新在 TE 沿之后、
+     * 扫描线越过起始行时才开始; 写入慢于扫描时按 "下一帧扫描线追上之前能写完" 的行数拆片,
+     * 写入快于扫描时整块在扫描线到达前写完. 周期与传输速率均为实测值.
+     *
+     * scan_lines 为面板扫描方向的行数, 绘制的行方向须与扫描方向一致 (未用 MADCTL 交换 XY,
+     * 需要旋转时用 EnableSoftwareRotation);
+     * 为 0 时只把每次刷新的起点对齐到 TE 沿, 不拆片.
+     * 同时启用 EnableSlicing 时 TE 片取代按字节分片, 每片仍经 arbiter 申请总线.
+     * 须在 LvglPort::AddDisplay() 之前调用.
+     */
+    bool EnableTearingSync(gpio_num_t te_gpio, int scan_lines);
+    void DisableTearingSync();
 };
 
 }  // namespace wrapper
@@ -0,0 +1,139 @@
+#include "wrapper/frame-metrics.hpp"
+#include "esp_attr.h"
+#include "esp_timer.h"
+#include <algorithm>
+
+using namespace wrapper;
+
+// --- Recording ---
+
+void IRAM_ATTR FrameMetrics::AddLocked(Channel channel, uint32_t value)
+{
+    Window& w = windows_[channel];
+    w.samples[w.head] = value;
+    w.head = (w.head + 1) % kWindow;
+    if (w.count < kWindow)
+        w.count++;
+}
+
+void IRAM_ATTR FrameMetrics::CountFrameLocked(uint32_t dropped, int64_t now)
+{
+    frames_++;
+    dropped_ += dropped;
+    second_frames_++;
+    if (second_start_us_ == 0)
+    {
+        second_start_us_ = now;
+    }
+    else if (now - second_start_us_ >= 1000000)
+    {
+        fps_ = second_frames_;
+        second_frames_ = 0;
+        second_start_us_ = now;
+    }
+}
+
+void FrameMetrics::Add(Channel channel, uint32_t value)
+{
+    taskENTER_CRITICAL(&lock_);
+    AddLocked(channel, value);
+    taskEXIT_CRITICAL(&lock_);
+}
+
+void IRAM_ATTR FrameMetrics::AddFromIsr(Channel channel, uint32_t value)
+{
+    taskENTER_CRITICAL_ISR(&lock_);
+    AddLocked(channel, value);
+    taskEXIT_CRITICAL_ISR(&lock_);
+}
+
+void FrameMetrics::CountFrame(uint32_t dropped)
+{
+    int64_t now = esp_timer_get_time();
+    taskENTER_CRITICAL(&lock_);
+    CountFrameLocked(dropped, now);
+    taskEXIT_CRITICAL(&lock_);
+}
+
+void IRAM_ATTR FrameMetrics::CountFrameFromIsr(uint32_t dropped)
+{
+    int64_t now = esp_timer_get_time();
+    taskENTER_CRITICAL_ISR(&lock_);
+    CountFrameLocked(dropped, now);
+    taskEXIT_CRITICAL_ISR(&lock_);
+}
+
+void FrameMetrics::Reset()
+{
+    taskENTER_CRITICAL(&lock_);
+    for (Window& w : windows_)
+    {
+        w.head = 0;
+        w.count = 0;
+    }
+    frames_ = 0;
+    dropped_ = 0;
+    fps_ = 0;
+    second_frames_ = 0;
+    second_start_us_ = 0;
+    taskEXIT_CRITICAL(&lock_);
+}
+
+// --- Summary ---
+
+FrameMetricSummary FrameMetrics::Summarize(const Window& window)
+{
+    FrameMetricSummary s;
+    if (window.count == 0)
+        return s;
+
+    // 窗口很小, 拷贝后排序即可
+    uint32_t sorted[kWindow];
+    std::copy(window.samples, window.samples + window.count, sorted);
+    std::sort(sorted, sorted + window.count);
+    uint64_t sum = 0;
+    for (uint32_t i = 0; i < window.count; i++)
+        sum += sorted[i];
+
+    s.samples = window.count;
+    s.min = sorted[0];
+    s.max = sorted[window.count - 1];
+    s.avg = (uint32_t)(sum / window.count);
+    s.p99 = sorted[(window.count * 99 + 99) / 100 - 1];
+    return s;
+}
+
+FrameMetricsSnapshot FrameMetrics::Snapshot() const
+{
+    Window copy[kChannels];
+    FrameMetricsSnapshot snapshot;
+    taskENTER_CRITICAL(&lock_);
+    std::copy(windows_, windows_ + kChannels, copy);
+    snapshot.frames = frames_;
+    snapshot.dropped = dropped_;
+    snapshot.fps = fps_;
+    taskEXIT_CRITICAL(&lock_);
+
+    snapshot.render_us = Summarize(copy[kRenderUs]);
+    snapshot.flush_wait_us = Summarize(copy[kFlushWaitUs]);
+    snapshot.dma_us = Summarize(copy[kDmaUs]);
+    snapshot.bytes = Summarize(copy[kBytes]);
+    return snapshot;
+}
+
+static void PrintSummary(FILE* out, const char* name, const FrameMetricSummary& s)
+{
+    fprintf(out, "  %-10s n=%-3lu min=%-7lu avg=%-7lu p99=%-7lu max=%lu\n", name,
+            (unsigned long)s.samples, (unsigned long)s.min, (unsigned long)s.avg,
+            (unsigned long)s.p99, (unsigned long)s.max);
+}
+
+void FrameMetrics::Print(FILE* out, const FrameMetricsSnapshot& snapshot)
+{
+    fprintf(out, "frames=%lu dropped=%lu fps=%lu\n", (unsigned long)snapshot.frames,
+            (unsigned long)snapshot.dropped, (unsigned long)snapshot.fps);
+    PrintSummary(out, "render_us", snapshot.render_us);
+    PrintSummary(out, "wait_us", snapshot.flush_wait_us);
+    PrintSummary(out, "dma_us", snapshot.dma_us);
+    PrintSummary(out, "bytes", snapshot.bytes);
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include "freertos/FreeRTOS.h"
+
+namespace wrapper
+{
+
+// 一个滚动窗口内的统计; samples 为窗口内样本数 (不超过 FrameMetrics::kWindow)
+struct FrameMetricSummary
+{
+    uint32_t samples = 0;
+    uint32_t min = 0;
+    uint32_t avg = 0;
+    uint32_t p99 = 0;
+    uint32_t max = 0;
+};
+
+struct FrameMetricsSnapshot
+{
+    FrameMetricSummary render_us;      // LVGL 渲染 (不含等待刷新)
+    FrameMetricSummary flush_wait_us;  // 渲染方等待缓冲/传输完成
+    FrameMetricSummary dma_us;         // 颜色数据传输
+    FrameMetricSummary bytes;          // 每帧发送的像素字节
+    uint32_t frames = 0;
+    uint32_t dropped = 0;  // 单帧耗时超过刷新周期而错过的周期数
+    uint32_t fps = 0;      // 最近一个完整秒内的帧数
+};
+
+/**
+ * @brief 帧耗时与吞吐的滚动窗口统计
+ *
+ * 每个通道保留最近 kWindow 个样本, Snapshot() 时计算 min/avg/p99/max.
+ * DisplayBase 记录刷新侧 (传输耗时、字节、缓冲等待), LvglPort 记录渲染侧并合并两者.
+ */
+class FrameMetrics
+{
+   public:
+    static constexpr size_t kWindow = 64;
+
+    enum Channel
+    {
+        kRenderUs,
+        kFlushWaitUs,
+        kDmaUs,
+        kBytes,
+        kChannels,
+    };
+
+    FrameMetrics() = default;
+
+    FrameMetrics(const FrameMetrics&) = delete;
+    FrameMetrics& operator=(const FrameMetrics&) = delete;
+
+    void Add(Channel channel, uint32_t value);
+    void AddFromIsr(Channel channel, uint32_t value);
+    // 一帧结束; dropped 为该帧错过的刷新周期数
+    void CountFrame(uint32_t dropped);
+    void CountFrameFromIsr(uint32_t dropped);
+
+    FrameMetricsSnapshot Snapshot() const;
+    void Reset();
+
+    static void Print(FILE* out, const FrameMetricsSnapshot& snapshot);
+
+   private:
+    struct Window
+    {
+        uint32_t samples[kWindow];
+        uint32_t head;
+        uint32_t count;
+    };
+
+    Window windows_[kChannels] = {};
+    uint32_t frames_ = 0;
+    uint32_t dropped_ = 0;
+    uint32_t fps_ = 0;
+    uint32_t second_frames_ = 0;
+    int64_t second_start_us_ = 0;
+    mutable portMUX_TYPE lock_ = portMUX_INITIALIZER_UNLOCKED;
+
+    void AddLocked(Channel channel, uint32_t value);
+    void CountFrameLocked(uint32_t dropped, int64_t now);
+    static FrameMetricSummary Summarize(const Window& window);
+};
+
+}  // namespace wrapper
@@ -0,0 +1,267 @@
+#include "wrapper/i2c-sampler.hpp"
+#include "esp_timer.h"
+#include <cstring>
+
+using namespace wrapper;
+
+// --- I2cSampler ---
+
+I2cSampler::I2cSampler(Logger& logger)
+    : logger_(logger), active_{}, task_(nullptr), should_exit_(false)
+{
+    jobs_lock_ = xSemaphoreCreateMutexStatic(&jobs_lock_buffer_);
+    exit_sem_ = xSemaphoreCreateBinaryStatic(&exit_sem_buffer_);
+}
+
+I2cSampler::~I2cSampler() { Stop(); }
+
+int I2cSampler::AddJob(I2cDevice& device, uint8_t reg_addr, uint8_t len, uint32_t period_ms)
+{
+    if (len == 0 || len > kMaxSampleBytes || period_ms == 0)
+    {
+        logger_.Error("Invalid job: reg 0x%02X, len %u, period %u ms", reg_addr, len,
+                      (unsigned)period_ms);
+        return -1;
+    }
+
+    xSemaphoreTake(jobs_lock_, portMAX_DELAY);
+    int id = -1;
+    for (size_t i = 0; i < kMaxJobs; i++)
+    {
+        if (!active_[i])
+        {
+            id = (int)i;
+            break;
+        }
+    }
+    if (id >= 0)
+    {
+        Job& job = jobs_[id];
+        job.device = &device;
+        job.reg = reg_addr;
+        job.len = len;
+        job.period_us = period_ms * 1000;
+        job.next_due_us = esp_timer_get_time();
+        job.head.store(0);
+        job.tail.store(0);
+        job.samples.store(0);
+        job.errors.store(0);
+        job.dropped.store(0);
+        active_[id] = true;
+    }
+    xSemaphoreGive(jobs_lock_);
+
+    if (id < 0)
+    {
+        logger_.Error("Job table full (%u)", (unsigned)kMaxJobs);
+        return -1;
+    }
+    if (task_ != nullptr)
+    {
+        xTaskNotifyGive(task_);
+    }
+    logger_.Info("Job %d: addr 0x%02X reg 0x%02X x%u every %u ms", id, device.GetAddress(),
+                 reg_addr, len, (unsigned)period_ms);
+    return id;
+}
+
+bool I2cSampler::RemoveJob(int id)
+{
+    if (id < 0 || id >= (int)kMaxJobs)
+        return false;
+    xSemaphoreTake(jobs_lock_, portMAX_DELAY);
+    bool was_active = active_[id];
+    active_[id] = false;
+    xSemaphoreGive(jobs_lock_);
+    return was_active;
+}
+
+bool I2cSampler::Start(UBaseType_t priority, uint32_t stack_depth)
+{
+    if (task_ != nullptr)
+    {
+        logger_.Warning("Already started");
+        return false;
+    }
+    should_exit_.store(false);
+    xSemaphoreTake(exit_sem_, 0);
+    if (xTaskCreate(&I2cSampler::TaskLoop, "i2c_sampler", stack_depth, this, priority, &task_) !=
+        pdPASS)
+    {
+        task_ = nullptr;
+        logger_.Error("Failed to create sampler task");
+        return false;
+    }
+    return true;
+}
+
+bool I2cSampler::Stop()
+{
+    if (task_ == nullptr)
+        return true;
+    should_exit_.store(true);
+    xTaskNotifyGive(task_);
+    xSemaphoreTake(exit_sem_, portMAX_DELAY);
+    task_ = nullptr;
+    logger_.Info("Stopped");
+    return true;
+}
+
+// --- I2cSampler consumer side ---
+
+bool I2cSampler::Pop(int id, I2cSample& sample)
+{
+    if (!Valid(id))
+        return false;
+    Job& job = jobs_[id];
+    uint32_t tail = job.tail.load(std::memory_order_relaxed);
+    if (tail == job.head.load(std::memory_order_acquire))
+        return false;
+    sample = job.ring[tail & (kRingDepth - 1)];
+    job.tail.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+bool I2cSampler::Latest(int id, I2cSample& sample)
+{
+    if (!Valid(id))
+        return false;
+    Job& job = jobs_[id];
+    uint32_t head = job.head.load(std::memory_order_acquire);
+    if (job.tail.load(std::memory_order_relaxed) == head)
+        return false;
+    sample = job.ring[(head - 1) & (kRingDepth - 1)];
+    job.tail.store(head, std::memory_order_release);
+    return true;
+}
+
+size_t I2cSampler::Available(int id) const
+{
+    if (!Valid(id))
+        return 0;
+    const Job& job = jobs_[id];
+    return job.head.load(std::memory_order_acquire) - job.tail.load(std::memory_order_acquire);
+}
+
+I2cSampler::JobStats I2cSampler::GetJobStats(int id) const
+{
+    if (!Valid(id))
+        return {};
+    const Job& job = jobs_[id];
+    return {job.samples.load(), job.errors.load(), job.dropped.load()};
+}
+
+// --- I2cSampler producer side ---
+
+void I2cSampler::Push(Job& job, int64_t timestamp_us)
+{
+    uint32_t head = job.head.load(std::memory_order_relaxed);
+    if (head - job.tail.load(std::memory_order_acquire) >= kRingDepth)
+    {
+        job.dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    I2cSample& slot = job.ring[head & (kRingDepth - 1)];
+    slot.timestamp_us = timestamp_us;
+    slot.len = job.len;
+    memcpy(slot.data, job.staging, job.len);
+    job.head.store(head + 1, std::memory_order_release);
+    job.samples.fetch_add(1, std::memory_order_relaxed);
+}
+
+void I2cSampler::Flush(I2cDevice& device, const int* batch, size_t count)
+{
+    bool ok = device.Execute(txn_, kTimeoutMs);
+    int64_t now = esp_timer_get_time();
+    for (size_t i = 0; i < count; i++)
+    {
+        Job& job = jobs_[batch[i]];
+        if (ok)
+            Push(job, now);
+        else
+            job.errors.fetch_add(1, std::memory_order_relaxed);
+    }
+    txn_.Clear();
+}
+
+int64_t I2cSampler::RunDue()
+{
+    int64_t now = esp_timer_get_time();
+    bool due[kMaxJobs] = {};
+    bool ran[kMaxJobs] = {};
+    for (size_t i = 0; i < kMaxJobs; i++)
+    {
+        due[i] = ran[i] = active_[i] && jobs_[i].next_due_us <= now + kCoalesceUs;
+    }
+
+    // 按设备分组, 同一设备的到期任务合并到同一个事务中
+    int batch[kMaxJobs];
+    for (size_t i = 0; i < kMaxJobs; i++)
+    {
+        if (!due[i])
+            continue;
+        I2cDevice& device = *jobs_[i].device;
+        size_t count = 0;
+        txn_.Clear();
+        for (size_t j = i; j < kMaxJobs; j++)
+        {
+            if (!due[j] || jobs_[j].device != &device)
+                continue;
+            if (count == kReadsPerTxn)
+            {
+                Flush(device, batch, count);
+                count = 0;
+            }
+            Job& job = jobs_[j];
+            txn_.ReadRegBytes(job.reg, job.staging, job.len);
+            batch[count++] = (int)j;
+            due[j] = false;
+        }
+        Flush(device, batch, count);
+    }
+
+    // 推进到期时间; 落后超过一个周期时重新对齐, 避免追赶式突发
+    now = esp_timer_get_time();
+    int64_t next_wait = INT64_MAX;
+    for (size_t i = 0; i < kMaxJobs; i++)
+    {
+        if (!active_[i])
+            continue;
+        Job& job = jobs_[i];
+        if (ran[i])
+        {
+            job.next_due_us += job.period_us;
+            if (job.next_due_us <= now)
+                job.next_due_us = now + job.period_us;
+        }
+        int64_t wait = job.next_due_us - now;
+        if (wait < next_wait)
+            next_wait = wait;
+    }
+    return next_wait;
+}
+
+void I2cSampler::TaskLoop(void* arg)
+{
+    I2cSampler* self = static_cast<I2cSampler*>(arg);
+    self->logger_.Info("Sampler task started");
+
+    while (!self->should_exit_.load())
+    {
+        xSemaphoreTake(self->jobs_lock_, portMAX_DELAY);
+        int64_t wait_us = self->RunDue();
+        xSemaphoreGive(self->jobs_lock_);
+
+        TickType_t ticks = portMAX_DELAY;
+        if (wait_us != INT64_MAX)
+        {
+            ticks = pdMS_TO_TICKS((wait_us + 999) / 1000);
+            if (ticks == 0)
+                ticks = 1;
+        }
+        ulTaskNotifyTake(pdTRUE, ticks);
+    }
+
+    xSemaphoreGive(self->exit_sem_);
+    vTaskDelete(nullptr);
+}
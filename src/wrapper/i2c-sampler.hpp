@@ -0,0 +1,110 @@
+#pragma once
+#include <atomic>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "wrapper/i2c.hpp"
+#include "wrapper/logger.hpp"
+
+namespace wrapper
+{
+
+struct I2cSample
+{
+    int64_t timestamp_us;  // esp_timer 时间戳, 同批次采样共用
+    uint8_t len;
+    uint8_t data[8];
+};
+
+/**
+ * @brief 周期寄存器采样引擎
+ *
+ * 注册 "每 T ms 从设备 D 的寄存器 R 读取 N 字节" 的任务, 由一个专用任务统一调度:
+ * 同一时刻到期 (kCoalesceUs 窗口内) 且属于同一设备的任务合并为一个 I2cTransaction,
+ * 一次获取总线背靠背执行. 结果带时间戳写入每个任务独立的无锁 SPSC 环形缓冲,
+ * 消费者调用 Pop()/Latest() 读取, 不访问总线.
+ *
+ * 环形缓冲满时丢弃新样本并计数 (Dropped). 每个任务只允许一个消费者.
+ */
+class I2cSampler
+{
+   public:
+    static constexpr size_t kMaxJobs = 16;
+    static constexpr size_t kMaxSampleBytes = sizeof(I2cSample::data);
+    static constexpr size_t kRingDepth = 16;  // 2 的幂
+    static constexpr int64_t kCoalesceUs = 1000;
+    static constexpr int kTimeoutMs = 50;
+
+    struct JobStats
+    {
+        uint32_t samples;
+        uint32_t errors;
+        uint32_t dropped;
+    };
+
+    I2cSampler(Logger& logger);
+    ~I2cSampler();
+
+    I2cSampler(const I2cSampler&) = delete;
+    I2cSampler& operator=(const I2cSampler&) = delete;
+
+    // 返回任务 ID, 失败返回 -1. 可在运行中调用
+    int AddJob(I2cDevice& device, uint8_t reg_addr, uint8_t len, uint32_t period_ms);
+    bool RemoveJob(int id);
+
+    bool Start(UBaseType_t priority = 5, uint32_t stack_depth = 4096);
+    bool Stop();
+    bool IsRunning() const { return task_ != nullptr; }
+
+    // --- 消费端 (无锁) ---
+    bool Pop(int id, I2cSample& sample);
+    // 丢弃积压, 只取最新一个样本
+    bool Latest(int id, I2cSample& sample);
+    size_t Available(int id) const;
+    JobStats GetJobStats(int id) const;
+
+   private:
+    static_assert((kRingDepth & (kRingDepth - 1)) == 0, "kRingDepth must be a power of two");
+
+    // 多字节读段占 7 个操作 (START, 写地址, 寄存器, START, 读地址, READ, READ), 另留 1 个给 STOP
+    static constexpr size_t kReadsPerTxn = (I2cTransaction::kMaxOps - 1) / 7;
+
+    struct Job
+    {
+        I2cDevice* device;
+        uint8_t reg;
+        uint8_t len;
+        uint32_t period_us;
+        int64_t next_due_us;
+        uint8_t staging[kMaxSampleBytes];
+
+        I2cSample ring[kRingDepth];
+        std::atomic<uint32_t> head;  // 生产者写
+        std::atomic<uint32_t> tail;  // 消费者写
+        std::atomic<uint32_t> samples;
+        std::atomic<uint32_t> errors;
+        std::atomic<uint32_t> dropped;
+    };
+
+    Logger& logger_;
+    Job jobs_[kMaxJobs];
+    bool active_[kMaxJobs];
+    I2cTransaction txn_;
+
+    StaticSemaphore_t jobs_lock_buffer_;
+    SemaphoreHandle_t jobs_lock_;
+    StaticSemaphore_t exit_sem_buffer_;
+    SemaphoreHandle_t exit_sem_;
+    TaskHandle_t task_;
+    std::atomic<bool> should_exit_;
+
+    bool Valid(int id) const { return id >= 0 && id < (int)kMaxJobs && active_[id]; }
+    void Push(Job& job, int64_t timestamp_us);
+    // 执行一个周期, 返回距离下一次到期的微秒数
+    int64_t RunDue();
+    void Flush(I2cDevice& device, const int* batch, size_t count);
+
+    static void TaskLoop(void* arg);
+};
+
+}  // namespace wrapper
@@ -1,13 +1,25 @@
 #include "wrapper/i2c.hpp"
-#include <iomanip>
-#include <sstream>
+#include "esp_attr.h"
+#include "esp_timer.h"
+#include "freertos/task.h"
+#include <cstdio>
 #include <cstring>
 #include <vector>
 
 // --- I2cBus ---
 using namespace wrapper;
 
-I2cBus::I2cBus(Logger& logger) : logger_(logger), bus_handle_(nullptr) {}
+I2cBus::I2cBus(Logger& logger)
+    : logger_(logger),
+      bus_handle_(nullptr),
+      async_(false),
+      sched_lock_(portMUX_INITIALIZER_UNLOCKED),
+      sched_busy_(false),
+      sched_waiters_(nullptr),
+      aging_ms_(20),
+      recoveries_(0)
+{
+}
 
 I2cBus::~I2cBus() { Deinit(); }
 
@@ -31,6 +43,8 @@ bool I2cBus::Init(const I2cBusConfig& config)
         logger_.Info("Initialized (Port: %d, SDA: %d, SCL: %d)", config.i2c_port, config.sda_io_num,
                      config.scl_io_num);
         port_ = (i2c_port_t)config.i2c_port;
+        async_ = config.trans_queue_depth > 0;
+        stats_.Attach("i2c%d", (int)port_);
         return true;
     }
     else
@@ -49,6 +63,7 @@ bool I2cBus::Deinit()
         {
             logger_.Info("Deinitialized");
             bus_handle_ = nullptr;
+            stats_.Detach();
             return true;
         }
         else
@@ -81,6 +96,23 @@ bool I2cBus::Reset()
     }
 }
 
+esp_err_t I2cBus::RecoverLocked() const
+{
+    if (bus_handle_ == nullptr)
+        return ESP_ERR_INVALID_STATE;
+    if (async_)
+    {
+        i2c_master_bus_wait_all_done(bus_handle_, 10);
+    }
+    esp_err_t ret = i2c_master_bus_reset(bus_handle_);
+    recoveries_.fetch_add(1, std::memory_order_relaxed);
+    if (ret != ESP_OK)
+    {
+        logger_.Error("Bus recovery failed: %s", esp_err_to_name(ret));
+    }
+    return ret;
+}
+
 bool I2cBus::Probe(int addr) { return ProbeInternal(addr) == ESP_OK; }
 
 esp_err_t I2cBus::ProbeInternal(int addr)
@@ -91,7 +123,118 @@ esp_err_t I2cBus::ProbeInternal(int addr)
     }
 
     // Default timeout 50ms for probing
-    return i2c_master_probe(bus_handle_, static_cast<uint16_t>(addr), 50);
+    if (!Acquire(I2cPriority::Background, 50))
+    {
+        return ESP_ERR_TIMEOUT;
+    }
+    esp_err_t ret = i2c_master_probe(bus_handle_, static_cast<uint16_t>(addr), 50);
+    Release();
+    return ret;
+}
+
+bool I2cBus::Acquire(I2cPriority priority, int timeout_ms) const
+{
+    taskENTER_CRITICAL(&sched_lock_);
+    if (!sched_busy_)
+    {
+        sched_busy_ = true;
+        taskEXIT_CRITICAL(&sched_lock_);
+        return true;
+    }
+    taskEXIT_CRITICAL(&sched_lock_);
+
+    StaticSemaphore_t sem_buffer;
+    Waiter self = {priority, esp_timer_get_time(), false, xSemaphoreCreateBinaryStatic(&sem_buffer),
+                   nullptr};
+
+    taskENTER_CRITICAL(&sched_lock_);
+    if (!sched_busy_)
+    {
+        sched_busy_ = true;
+        taskEXIT_CRITICAL(&sched_lock_);
+        return true;
+    }
+    // 追加到队尾, 同等级按到达顺序服务
+    Waiter** link = &sched_waiters_;
+    while (*link != nullptr)
+    {
+        link = &(*link)->next;
+    }
+    *link = &self;
+    taskEXIT_CRITICAL(&sched_lock_);
+
+    TickType_t ticks = timeout_ms < 0 ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms);
+    if (xSemaphoreTake(self.sem, ticks) == pdTRUE)
+    {
+        return true;
+    }
+
+    taskENTER_CRITICAL(&sched_lock_);
+    bool granted = self.granted;
+    if (!granted)
+    {
+        for (link = &sched_waiters_; *link != nullptr; link = &(*link)->next)
+        {
+            if (*link == &self)
+            {
+                *link = self.next;
+                break;
+            }
+        }
+    }
+    taskEXIT_CRITICAL(&sched_lock_);
+
+    if (granted)
+    {
+        // Release 已选中本任务, 等它完成 Give 后才能让节点出栈
+        xSemaphoreTake(self.sem, portMAX_DELAY);
+    }
+    return granted;
+}
+
+void I2cBus::Release() const
+{
+    Waiter* best = nullptr;
+    Waiter** best_link = nullptr;
+
+    taskENTER_CRITICAL(&sched_lock_);
+    int64_t now = esp_timer_get_time();
+    int64_t aging_us = (int64_t)aging_ms_ * 1000;
+    int best_rank = 0;
+    for (Waiter** link = &sched_waiters_; *link != nullptr; link = &(*link)->next)
+    {
+        Waiter* w = *link;
+        int rank = (int)w->priority;
+        if (aging_us > 0 && rank > (int)I2cPriority::Normal)
+        {
+            int64_t steps = (now - w->enqueue_us) / aging_us;
+            rank = steps >= rank - (int)I2cPriority::Normal ? (int)I2cPriority::Normal
+                                                             : rank - (int)steps;
+        }
+        if (best == nullptr || rank < best_rank)
+        {
+            best = w;
+            best_link = link;
+            best_rank = rank;
+        }
+    }
+
+    if (best != nullptr)
+    {
+        // 直接移交, sched_busy_ 保持为 true
+        *best_link = best->next;
+        best->granted = true;
+    }
+    else
+    {
+        sched_busy_ = false;
+    }
+    taskEXIT_CRITICAL(&sched_lock_);
+
+    if (best != nullptr)
+    {
+        xSemaphoreGive(best->sem);
+    }
 }
 
 bool I2cBus::Scan(const std::vector<uint8_t>& addrs)
@@ -142,224 +285,1382 @@ bool I2cBus::Scan(int start_addr, int end_addr)
             continue;
         }
 
-        std::stringstream ss;
-        ss << std::hex << std::setw(2) << std::setfill('0') << i << ":";
+        char line[4 + 16 * 3 + 1];
+        int pos = snprintf(line, sizeof(line), "%02x:", i);
 
         for (int j = 0; j < 16; j++)
         {
             int addr = i + j;
+            const char* cell = " --";
+            char found[4];
             if (addr < start_addr || addr > end_addr)
             {
-                ss << "   ";
+                cell = "   ";
             }
             else
             {
                 esp_err_t ret = ProbeInternal(addr);
                 if (ret == ESP_OK)
                 {
-                    ss << " " << std::hex << std::setw(2) << std::setfill('0') << addr;
+                    snprintf(found, sizeof(found), " %02x", addr);
+                    cell = found;
                     found_count++;
                 }
                 else if (ret == ESP_ERR_TIMEOUT)
                 {
-                    ss << " UU";
-                }
-                else
-                {
-                    ss << " --";
+                    cell = " UU";
                 }
             }
+            memcpy(line + pos, cell, 3);
+            pos += 3;
         }
-        logger_.Info("%s", ss.str().c_str());
+        line[pos] = '\0';
+        logger_.Info("%s", line);
     }
 
     logger_.Info("Scan complete. Found %d devices.", found_count);
     return true;  // Always return true if scan completed without fatal bus error
 }
 
-bool I2cBus::Scan() { return Scan(0x00, 0x7F); }
-
-// --- I2cDevice ---
+bool I2cBus::Enumerate(I2cPresence& presence, int timeout_ms)
+{
+    presence = {};
+    if (bus_handle_ == nullptr)
+    {
+        logger_.Error("Cannot enumerate: Not initialized");
+        return false;
+    }
 
-I2cDevice::I2cDevice(Logger& logger) : logger_(logger), dev_handle_(nullptr) {}
+    const int base_timeout = timeout_ms > 0 ? timeout_ms : 1;
+    const int max_timeout = base_timeout * 8;
+    int probe_timeout = base_timeout;
+    int consecutive_timeouts = 0;
 
-I2cDevice::~I2cDevice() { Deinit(); }
+    if (!Acquire(I2cPriority::Interactive, -1))
+    {
+        return false;
+    }
+    for (int addr = 0x08; addr <= 0x77; addr++)
+    {
+        esp_err_t ret = i2c_master_probe(bus_handle_, static_cast<uint16_t>(addr), probe_timeout);
+        if (ret == ESP_ERR_TIMEOUT)
+        {
+            if (++consecutive_timeouts >= kMaxProbeTimeouts)
+            {
+                Release();
+                logger_.Error("Enumerate aborted at 0x%02X: bus stuck", addr);
+                return false;
+            }
+            probe_timeout = probe_timeout * 2 > max_timeout ? max_timeout : probe_timeout * 2;
+            continue;
+        }
 
-Logger& I2cDevice::GetLogger() { return logger_; }
+        consecutive_timeouts = 0;
+        probe_timeout = base_timeout;
+        if (ret == ESP_OK)
+        {
+            presence.Set(static_cast<uint8_t>(addr));
+        }
+    }
+    Release();
+    return true;
+}
 
-bool I2cDevice::Init(const I2cBus& bus, const I2cDeviceConfig& config)
+size_t I2cBus::Identify(const I2cPresence& presence,
+                        std::span<const I2cSignature> table,
+                        std::span<const I2cSignature*> matches)
 {
-    if (dev_handle_ != nullptr)
+    size_t count = 0;
+    I2cPresence matched;
+
+    for (const I2cSignature& sig : table)
     {
-        logger_.Warning("Device already initialized. Deinitializing first.");
-        Deinit();
+        if (count >= matches.size())
+            break;
+        if (!presence.Test(sig.addr) || matched.Test(sig.addr))
+            continue;
+
+        if (sig.id_reg >= 0)
+        {
+            // 临时挂载设备读取 ID 寄存器, 读完即移除
+            I2cDeviceConfig config(sig.addr, 100000);
+            i2c_master_dev_handle_t dev = nullptr;
+            if (i2c_master_bus_add_device(bus_handle_, &config, &dev) != ESP_OK)
+                continue;
+
+            uint8_t reg = static_cast<uint8_t>(sig.id_reg);
+            uint8_t value = 0;
+            esp_err_t ret = ESP_FAIL;
+            if (Acquire(I2cPriority::Interactive, -1))
+            {
+                ret = i2c_master_transmit_receive(dev, &reg, 1, &value, 1, 20);
+                Release();
+            }
+            i2c_master_bus_rm_device(dev);
+            if (ret != ESP_OK || (value & sig.id_mask) != sig.id_value)
+                continue;
+        }
+
+        matched.Set(sig.addr);
+        matches[count++] = &sig;
     }
+    return count;
+}
 
-    if (bus.GetHandle() == nullptr)
+bool I2cBus::Detect()
+{
+    I2cPresence presence;
+    if (!Enumerate(presence))
     {
-        logger_.Error("Bus not initialized");
         return false;
     }
 
-    esp_err_t ret = i2c_master_bus_add_device(bus.GetHandle(), &config, &dev_handle_);
-    if (ret == ESP_OK)
+    const I2cSignature* matches[16];
+    size_t n = Identify(presence, KnownSignatures(), matches);
+    I2cPresence identified;
+    for (size_t i = 0; i < n; i++)
     {
-        logger_.Info("Device initialized (Addr: 0x%02X)", config.device_address);
-        return true;
+        identified.Set(matches[i]->addr);
+        logger_.Info("0x%02X: %s", matches[i]->addr, matches[i]->name);
     }
-    else
+    for (int addr = 0x08; addr <= 0x77; addr++)
     {
-        logger_.Error("Failed to add device: %s", esp_err_to_name(ret));
-        return false;
+        if (presence.Test(addr) && !identified.Test(addr))
+        {
+            logger_.Info("0x%02X: unknown", addr);
+        }
     }
+    logger_.Info("Detect complete. Found %u devices.", (unsigned)presence.Count());
+    return true;
 }
 
-bool I2cDevice::Deinit()
+std::span<const I2cSignature> I2cBus::KnownSignatures()
 {
-    if (dev_handle_ == nullptr)
+    // 带 ID 校验的条目排在同地址的纯地址条目之前
+    static const I2cSignature kSignatures[] = {
+        {0x34, "AXP2101", 0x03, 0xFF, 0x4A},
+        {0x34, "TCA8418", -1, 0x00, 0x00},
+        {0x58, "AW9523", 0x10, 0xFF, 0x23},
+        {0x18, "ES8311", 0xFD, 0xFF, 0x83},
+        {0x68, "BMI270", 0x00, 0xFF, 0x24},
+        {0x6B, "BQ25896", 0x14, 0x38, 0x00},
+        {0x43, "PI4IOE5V6408", 0x01, 0xE0, 0xA0},
+        {0x44, "PI4IOE5V6408", 0x01, 0xE0, 0xA0},
+        {0x5D, "GT911", -1, 0x00, 0x00},
+        {0x14, "GT911", -1, 0x00, 0x00},
+        {0x38, "FT5x06", -1, 0x00, 0x00},
+        {0x20, "XL9555", -1, 0x00, 0x00},
+        {0x75, "IP5306", -1, 0x00, 0x00},
+        {0x3C, "SSD1306", -1, 0x00, 0x00},
+    };
+    return kSignatures;
+}
+
+bool I2cBus::Scan() { return Scan(0x00, 0x7F); }
+
+// --- I2cTransaction ---
+
+I2cTransaction::I2cTransaction() { Clear(); }
+
+void I2cTransaction::Clear()
+{
+    op_count_ = 0;
+    buffer_used_ = 0;
+    segments_ = 0;
+    overflow_ = false;
+    addr_bytes_[0] = 0;
+    addr_bytes_[1] = 0;
+}
+
+bool I2cTransaction::Reserve(size_t ops, size_t bytes)
+{
+    // 末尾预留一个 STOP
+    if (op_count_ + ops + 1 > kMaxOps || buffer_used_ + bytes > kBufferSize)
     {
-        return true;
+        overflow_ = true;
+        return false;
     }
-    esp_err_t ret = i2c_master_bus_rm_device(dev_handle_);
-    if (ret == ESP_OK)
+    return true;
+}
+
+uint8_t* I2cTransaction::Stage(const uint8_t* data, size_t len)
+{
+    uint8_t* dst = buffer_ + buffer_used_;
+    if (len > 0)
     {
-        logger_.Info("Device deinitialized");
-        dev_handle_ = nullptr;
-        return true;
+        memcpy(dst, data, len);
     }
-    else
+    buffer_used_ += len;
+    return dst;
+}
+
+void I2cTransaction::PushStart()
+{
+    i2c_operation_job_t& op = ops_[op_count_++];
+    op = {};
+    op.command = I2C_MASTER_CMD_START;
+}
+
+void I2cTransaction::PushWrite(uint8_t* data, size_t len)
+{
+    i2c_operation_job_t& op = ops_[op_count_++];
+    op = {};
+    op.command = I2C_MASTER_CMD_WRITE;
+    op.write.ack_value = false;
+    op.write.ack_check = true;
+    op.write.data = data;
+    op.write.total_bytes = len;
+}
+
+void I2cTransaction::PushRead(uint8_t* data, size_t len, bool last)
+{
+    i2c_operation_job_t& op = ops_[op_count_++];
+    op = {};
+    op.command = I2C_MASTER_CMD_READ;
+    op.read.ack_value = last ? I2C_NACK_VAL : I2C_ACK_VAL;
+    op.read.data = data;
+    op.read.total_bytes = len;
+}
+
+size_t I2cTransaction::EncodeReg(uint16_t reg_addr, I2cRegAddr mode, uint8_t* out)
+{
+    switch (mode)
     {
-        logger_.Error("Failed to remove device: %s", esp_err_to_name(ret));
-        return false;
+        case I2cRegAddr::Bits16Be:
+            out[0] = (uint8_t)(reg_addr >> 8);
+            out[1] = (uint8_t)(reg_addr & 0xFF);
+            return 2;
+        case I2cRegAddr::Bits16Le:
+            out[0] = (uint8_t)(reg_addr & 0xFF);
+            out[1] = (uint8_t)(reg_addr >> 8);
+            return 2;
+        case I2cRegAddr::Bits8:
+        default:
+            out[0] = (uint8_t)reg_addr;
+            return 1;
     }
 }
 
-bool I2cDevice::WriteBytes(const std::vector<uint8_t>& data, int timeout_ms)
+bool I2cTransaction::WriteReg8(uint8_t reg_addr, uint8_t data)
 {
-    if (dev_handle_ == nullptr)
-        return false;
-    return i2c_master_transmit(dev_handle_, data.data(), data.size(), timeout_ms) == ESP_OK;
+    return WriteRegBytes(reg_addr, I2cRegAddr::Bits8, &data, 1);
 }
 
-bool I2cDevice::ReadBytes(std::vector<uint8_t>& data, size_t len, int timeout_ms)
+bool I2cTransaction::WriteRegBytes(uint8_t reg_addr, const uint8_t* data, size_t len)
 {
-    if (dev_handle_ == nullptr)
-        return false;
-    data.resize(len);
-    return i2c_master_receive(dev_handle_, data.data(), len, timeout_ms) == ESP_OK;
+    return WriteRegBytes(reg_addr, I2cRegAddr::Bits8, data, len);
 }
 
-bool I2cDevice::WriteReadBytes(const std::vector<uint8_t>& write_data,
-                               std::vector<uint8_t>& read_data,
-                               size_t read_len,
-                               int timeout_ms)
+bool I2cTransaction::WriteRegBytes(uint16_t reg_addr,
+                                   I2cRegAddr mode,
+                                   const uint8_t* data,
+                                   size_t len)
 {
-    if (dev_handle_ == nullptr)
+    uint8_t reg[2];
+    size_t reg_len = EncodeReg(reg_addr, mode, reg);
+    if (!Reserve(3, reg_len + len))
         return false;
-    read_data.resize(read_len);
-    return i2c_master_transmit_receive(dev_handle_, write_data.data(), write_data.size(),
-                                       read_data.data(), read_len, timeout_ms) == ESP_OK;
+    uint8_t* staged = Stage(reg, reg_len);
+    Stage(data, len);
+    PushStart();
+    PushWrite(&addr_bytes_[0], 1);
+    PushWrite(staged, reg_len + len);
+    segs_[segments_++] = {(uint8_t)reg_addr, false, mode != I2cRegAddr::Bits8, staged + reg_len,
+                          len};
+    return true;
 }
 
-bool I2cDevice::WriteByte(uint8_t data, int timeout_ms)
+bool I2cTransaction::ReadReg8(uint8_t reg_addr, uint8_t& data)
 {
-    if (dev_handle_ == nullptr)
-        return false;
-    return i2c_master_transmit(dev_handle_, &data, 1, timeout_ms) == ESP_OK;
+    return ReadRegBytes(reg_addr, &data, 1);
 }
 
-bool I2cDevice::ReadByte(uint8_t& data, int timeout_ms)
+bool I2cTransaction::ReadRegBytes(uint8_t reg_addr, uint8_t* data, size_t len)
 {
-    if (dev_handle_ == nullptr)
-        return false;
-    return i2c_master_receive(dev_handle_, &data, 1, timeout_ms) == ESP_OK;
+    return ReadRegBytes(reg_addr, I2cRegAddr::Bits8, data, len);
 }
 
-bool I2cDevice::WriteRegBytes(uint8_t reg_addr, const std::vector<uint8_t>& data, int timeout_ms)
+bool I2cTransaction::ReadRegBytes(uint16_t reg_addr, I2cRegAddr mode, uint8_t* data, size_t len)
 {
-    if (dev_handle_ == nullptr)
+    if (len == 0)
         return false;
-
-    // Optimization: Use stack for small data
-    size_t total_len = 1 + data.size();
-    if (total_len <= 128)
-    {
-        uint8_t buffer[128];
-        buffer[0] = reg_addr;
-        if (!data.empty())
-        {
-            memcpy(buffer + 1, data.data(), data.size());
-        }
-        return i2c_master_transmit(dev_handle_, buffer, total_len, timeout_ms) == ESP_OK;
-    }
-    else
+    uint8_t reg[2];
+    size_t reg_len = EncodeReg(reg_addr, mode, reg);
+    // START, W-addr, reg, START, R-addr, [READ ACK], READ NACK
+    size_t ops = len > 1 ? 7 : 6;
+    if (!Reserve(ops, reg_len))
+        return false;
+    PushStart();
+    PushWrite(&addr_bytes_[0], 1);
+    PushWrite(Stage(reg, reg_len), reg_len);
+    PushStart();
+    PushWrite(&addr_bytes_[1], 1);
+    if (len > 1)
     {
-        std::vector<uint8_t> buffer;
-        buffer.reserve(total_len);
-        buffer.push_back(reg_addr);
-        buffer.insert(buffer.end(), data.begin(), data.end());
-        return i2c_master_transmit(dev_handle_, buffer.data(), buffer.size(), timeout_ms) == ESP_OK;
+        PushRead(data, len - 1, false);
     }
+    PushRead(data + len - 1, 1, true);
+    segs_[segments_++] = {(uint8_t)reg_addr, true, mode != I2cRegAddr::Bits8, data, len};
+    return true;
 }
 
-bool I2cDevice::ReadRegBytes(uint8_t reg_addr,
-                             std::vector<uint8_t>& data,
-                             size_t len,
-                             int timeout_ms)
+// --- I2cCompletion ---
+
+I2cCompletion::I2cCompletion()
+    : done_(true),
+      result_(ESP_OK),
+      callback_(nullptr),
+      callback_arg_(nullptr),
+      notify_task_(nullptr)
 {
-    if (dev_handle_ == nullptr)
-        return false;
-    data.resize(len);
-    return i2c_master_transmit_receive(dev_handle_, &reg_addr, 1, data.data(), len, timeout_ms) ==
-           ESP_OK;
+    sem_ = xSemaphoreCreateBinaryStatic(&sem_buffer_);
 }
 
-bool I2cDevice::WriteReg8(uint8_t reg_addr, uint8_t data, int timeout_ms)
+void I2cCompletion::OnComplete(Callback callback, void* arg)
 {
-    if (dev_handle_ == nullptr)
-        return false;
-    uint8_t buffer[2] = {reg_addr, data};
-    return i2c_master_transmit(dev_handle_, buffer, 2, timeout_ms) == ESP_OK;
+    callback_ = callback;
+    callback_arg_ = arg;
 }
 
-bool I2cDevice::ReadReg8(uint8_t reg_addr, uint8_t& data, int timeout_ms)
+void I2cCompletion::NotifyTask(TaskHandle_t task) { notify_task_ = task; }
+
+bool I2cCompletion::Wait(int timeout_ms)
 {
-    if (dev_handle_ == nullptr)
-        return false;
-    return i2c_master_transmit_receive(dev_handle_, &reg_addr, 1, &data, 1, timeout_ms) == ESP_OK;
+    if (Done())
+        return true;
+    TickType_t ticks = timeout_ms < 0 ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms);
+    if (xSemaphoreTake(sem_, ticks) != pdTRUE)
+        return Done();
+    // Complete() 最后才写 done_; 等它写完, 返回后调用方即可销毁本对象
+    while (!Done())
+    {
+    }
+    return true;
 }
 
-bool I2cDevice::WriteReg16(uint8_t reg_addr, uint16_t data, int timeout_ms)
+void I2cCompletion::Arm()
 {
-    if (dev_handle_ == nullptr)
-        return false;
-    // Big Endian
-    uint8_t buffer[3] = {reg_addr, (uint8_t)(data >> 8), (uint8_t)(data & 0xFF)};
-    return i2c_master_transmit(dev_handle_, buffer, 3, timeout_ms) == ESP_OK;
+    // 清掉上一次遗留的信号
+    xSemaphoreTake(sem_, 0);
+    result_ = ESP_ERR_TIMEOUT;
+    done_.store(false, std::memory_order_release);
 }
 
-bool I2cDevice::ReadReg16(uint8_t reg_addr, uint16_t& data, int timeout_ms)
+void I2cCompletion::Fail(esp_err_t result)
 {
-    if (dev_handle_ == nullptr)
+    result_ = result;
+    done_.store(true, std::memory_order_release);
+}
+
+bool IRAM_ATTR I2cCompletion::Complete(esp_err_t result, bool from_isr)
+{
+    // done_ 必须最后发布: 一旦为 true, 等待方可能立即返回并销毁栈上的本对象
+    result_ = result;
+    if (callback_ != nullptr)
+    {
+        callback_(result, callback_arg_);
+    }
+
+    if (!from_isr)
+    {
+        // 挂起调度, 被唤醒的高优先级等待方不会在写 done_ 之前抢占本任务而空转
+        vTaskSuspendAll();
+        if (notify_task_ != nullptr)
+        {
+            xTaskNotifyGive(notify_task_);
+        }
+        xSemaphoreGive(sem_);
+        done_.store(true, std::memory_order_release);
+        xTaskResumeAll();
         return false;
-    uint8_t buffer[2];
-    esp_err_t ret = i2c_master_transmit_receive(dev_handle_, &reg_addr, 1, buffer, 2, timeout_ms);
-    if (ret == ESP_OK)
+    }
+
+    BaseType_t woken = pdFALSE;
+    if (notify_task_ != nullptr)
     {
-        data = ((uint16_t)buffer[0] << 8) | buffer[1];  // Big Endian
-        return true;
+        vTaskNotifyGiveFromISR(notify_task_, &woken);
     }
-    return false;
+    xSemaphoreGiveFromISR(sem_, &woken);
+    done_.store(true, std::memory_order_release);
+    return woken == pdTRUE;
 }
 
-bool I2cDevice::WriteReg32(uint8_t reg_addr, uint32_t data, int timeout_ms)
+// --- I2cDevice ---
+
+I2cDevice::I2cDevice(Logger& logger)
+    : logger_(logger),
+      dev_handle_(nullptr),
+      bus_handle_(nullptr),
+      bus_(nullptr),
+      config_{},
+      priority_(I2cPriority::Normal),
+      wait_stats_{},
+      address_(0),
+      reg_addr_mode_(I2cRegAddr::Bits8),
+      recovery_{},
+      consecutive_failures_(0),
+      quarantine_level_(0),
+      quarantine_until_us_(0),
+      async_(false),
+      pending_{},
+      pending_head_(0),
+      pending_count_(0),
+      completed_{},
+      completed_count_(0),
+      pending_lock_(portMUX_INITIALIZER_UNLOCKED),
+      submit_lock_(nullptr)
 {
-    if (dev_handle_ == nullptr)
+}
+
+I2cDevice::~I2cDevice() { Deinit(); }
+
+Logger& I2cDevice::GetLogger() { return logger_; }
+
+bool I2cDevice::Init(const I2cBus& bus, const I2cDeviceConfig& config)
+{
+    if (dev_handle_ != nullptr)
+    {
+        logger_.Warning("Device already initialized. Deinitializing first.");
+        Deinit();
+    }
+
+    if (bus.GetHandle() == nullptr)
+    {
+        logger_.Error("Bus not initialized");
         return false;
-    // Big Endian
-    uint8_t buffer[5] = {reg_addr, (uint8_t)(data >> 24), (uint8_t)(data >> 16),
-                         (uint8_t)(data >> 8), (uint8_t)(data & 0xFF)};
-    return i2c_master_transmit(dev_handle_, buffer, 5, timeout_ms) == ESP_OK;
+    }
+
+    esp_err_t ret = i2c_master_bus_add_device(bus.GetHandle(), &config, &dev_handle_);
+    if (ret != ESP_OK)
+    {
+        logger_.Error("Failed to add device: %s", esp_err_to_name(ret));
+        return false;
+    }
+
+    address_ = config.device_address;
+    bus_handle_ = bus.GetHandle();
+    bus_ = &bus;
+    config_ = config;
+    priority_ = config.priority;
+    async_ = bus.IsAsync();
+    stats_.Attach("i2c%d@0x%02X", (int)bus.GetPort(), (unsigned)address_);
+    if (async_)
+    {
+        if (submit_lock_ == nullptr)
+        {
+            submit_lock_ = xSemaphoreCreateMutexStatic(&submit_lock_buffer_);
+        }
+        ret = RegisterCallbacks();
+        if (ret != ESP_OK)
+        {
+            logger_.Error("Failed to register callbacks: %s", esp_err_to_name(ret));
+            i2c_master_bus_rm_device(dev_handle_);
+            dev_handle_ = nullptr;
+            return false;
+        }
+    }
+
+    logger_.Info("Device initialized (Addr: 0x%02X%s)", config.device_address,
+                 async_ ? ", async" : "");
+    return true;
+}
+
+bool I2cDevice::Deinit()
+{
+    if (dev_handle_ == nullptr)
+    {
+        return true;
+    }
+    if (async_ && bus_handle_ != nullptr)
+    {
+        // 等待在途传输完成, 避免 ISR 访问已释放的句柄
+        i2c_master_bus_wait_all_done(bus_handle_, -1);
+    }
+    esp_err_t ret = i2c_master_bus_rm_device(dev_handle_);
+    if (ret == ESP_OK)
+    {
+        logger_.Info("Device deinitialized");
+        dev_handle_ = nullptr;
+        bus_handle_ = nullptr;
+        bus_ = nullptr;
+        async_ = false;
+        pending_head_ = 0;
+        pending_count_ = 0;
+        completed_count_ = 0;
+        reg_cache_.Invalidate();
+        stats_.Detach();
+        return true;
+    }
+    else
+    {
+        logger_.Error("Failed to remove device: %s", esp_err_to_name(ret));
+        return false;
+    }
+}
+
+esp_err_t I2cDevice::Dispatch(const Op& op, int timeout_ms)
+{
+    switch (op.kind)
+    {
+        case OpKind::Transmit:
+            return i2c_master_transmit(dev_handle_, op.tx, op.tx_len, timeout_ms);
+        case OpKind::Receive:
+            return i2c_master_receive(dev_handle_, op.rx, op.rx_len, timeout_ms);
+        case OpKind::TransmitReceive:
+            return i2c_master_transmit_receive(dev_handle_, op.tx, op.tx_len, op.rx, op.rx_len,
+                                               timeout_ms);
+        case OpKind::MultiTransmit:
+            return i2c_master_multi_buffer_transmit(dev_handle_, op.buffers, op.job_count,
+                                                    timeout_ms);
+        case OpKind::Execute:
+            return i2c_master_execute_defined_operations(dev_handle_, op.jobs, op.job_count,
+                                                         timeout_ms);
+    }
+    return ESP_ERR_INVALID_ARG;
+}
+
+size_t I2cDevice::OpBytes(const Op& op)
+{
+    size_t bytes = op.tx_len + op.rx_len;
+    if (op.kind == OpKind::MultiTransmit)
+    {
+        for (size_t i = 0; i < op.job_count; i++)
+            bytes += op.buffers[i].buffer_size;
+    }
+    else if (op.kind == OpKind::Execute)
+    {
+        for (size_t i = 0; i < op.job_count; i++)
+        {
+            if (op.jobs[i].command == I2C_MASTER_CMD_WRITE)
+                bytes += op.jobs[i].write.total_bytes;
+            else if (op.jobs[i].command == I2C_MASTER_CMD_READ)
+                bytes += op.jobs[i].read.total_bytes;
+        }
+    }
+    return bytes;
+}
+
+void I2cDevice::DescribeOp(const Op& op, BusTraceKind& kind, uint8_t& reg)
+{
+    kind = BusTraceKind::I2cWrite;
+    reg = 0;
+    switch (op.kind)
+    {
+        case OpKind::Transmit:
+            reg = op.tx_len > 0 ? op.tx[0] : 0;
+            break;
+        case OpKind::Receive:
+            kind = BusTraceKind::I2cRead;
+            break;
+        case OpKind::TransmitReceive:
+            kind = BusTraceKind::I2cWriteRead;
+            reg = op.tx_len > 0 ? op.tx[0] : 0;
+            break;
+        case OpKind::MultiTransmit:
+            kind = BusTraceKind::I2cMultiWrite;
+            reg = op.buffers[0].buffer_size > 0 ? op.buffers[0].write_buffer[0] : 0;
+            break;
+        case OpKind::Execute:
+            // 事务布局: START, 写地址, 寄存器...
+            kind = BusTraceKind::I2cExecute;
+            if (op.job_count > 2 && op.jobs[2].command == I2C_MASTER_CMD_WRITE)
+                reg = op.jobs[2].write.data[0];
+            break;
+    }
+}
+
+void I2cDevice::RecordOp(BusTraceKind kind,
+                         uint8_t reg,
+                         size_t bytes,
+                         esp_err_t ret,
+                         int64_t start_us,
+                         uint32_t duration_us)
+{
+    if constexpr (BusStats::kEnabled)
+    {
+        stats_.Record(bytes, ret, duration_us);
+        bus_->GetStats().Record(bytes, ret, duration_us);
+    }
+    if constexpr (BusTrace::kEnabled)
+    {
+        BusTrace::Record(BusTrace::I2cId(bus_->GetPort(), address_), kind, reg, bytes, ret,
+                         start_us, duration_us);
+    }
+}
+
+esp_err_t I2cDevice::RunOnce(const Op& op, int timeout_ms, bool& acquired)
+{
+    int64_t wait_start = esp_timer_get_time();
+    acquired = bus_->Acquire(priority_, timeout_ms);
+    if (!acquired)
+        return ESP_ERR_TIMEOUT;
+    int64_t xfer_start = esp_timer_get_time();
+    uint32_t wait_us = (uint32_t)(xfer_start - wait_start);
+    wait_stats_.count++;
+    wait_stats_.total_us += wait_us;
+    if (wait_us > wait_stats_.max_us)
+    {
+        wait_stats_.max_us = wait_us;
+    }
+
+    esp_err_t ret = ESP_OK;
+    bool stuck = false;
+    if (!async_)
+    {
+        ret = Dispatch(op, timeout_ms);
+    }
+    else
+    {
+        // 异步总线上的阻塞调用: 提交后等待完成, 保证栈上缓冲区在返回前不再被访问
+        I2cCompletion done;
+        if (!Enqueue(op, done, timeout_ms, false))
+        {
+            ret = done.Result();
+        }
+        else if (!done.Wait(timeout_ms))
+        {
+            // 驱动仍持有栈上的收发缓冲, 先等硬件超时 (scl_wait_us) 产生的完成事件;
+            // 仍未完成说明驱动卡死, 撤回句柄并复位总线, 避免持有调度权无限期挂起
+            int grace_ms = (int)((config_.scl_wait_us + 999) / 1000) + kCompletionGraceMs;
+            if (!done.Wait(grace_ms))
+            {
+                logger_.Error("Transfer not completed %d ms after timeout, resetting bus",
+                              grace_ms);
+                stuck = true;
+                if (!Withdraw(done))
+                {
+                    // 完成 ISR 已弹出该句柄, 通知即将到达
+                    done.Wait(-1);
+                }
+            }
+            ret = ESP_ERR_TIMEOUT;
+        }
+        else
+        {
+            ret = done.Result();
+        }
+    }
+    if constexpr (BusStats::kEnabled || BusTrace::kEnabled)
+    {
+        BusTraceKind kind;
+        uint8_t reg;
+        DescribeOp(op, kind, reg);
+        RecordOp(kind, reg, OpBytes(op), ret, xfer_start,
+                 (uint32_t)(esp_timer_get_time() - xfer_start));
+    }
+    if (stuck ||
+        (recovery_.bus_recovery && (ret == ESP_ERR_TIMEOUT || ret == ESP_ERR_INVALID_STATE)))
+    {
+        // 超时或状态机异常多为 SDA 被拉低, 趁仍持有总线时恢复
+        bus_->RecoverLocked();
+    }
+    bus_->Release();
+    return ret;
+}
+
+esp_err_t I2cDevice::Run(const Op& op, int timeout_ms)
+{
+    if (dev_handle_ == nullptr)
+        return ESP_ERR_INVALID_STATE;
+    DrainCompleted();
+    if (IsQuarantined())
+        return ESP_ERR_NOT_ALLOWED;
+
+    uint32_t backoff_ms = recovery_.backoff_base_ms;
+    esp_err_t ret = ESP_OK;
+    for (int attempt = 0;; attempt++)
+    {
+        bool acquired = false;
+        ret = RunOnce(op, timeout_ms, acquired);
+        if (ret == ESP_OK)
+        {
+            consecutive_failures_ = 0;
+            quarantine_level_ = 0;
+            return ESP_OK;
+        }
+        // 等不到总线不算设备故障; 参数/内存错误重试无意义
+        if (!acquired)
+            return ret;
+        bool retryable = ret == ESP_ERR_TIMEOUT || ret == ESP_FAIL ||
+                         ret == ESP_ERR_INVALID_RESPONSE || ret == ESP_ERR_INVALID_STATE;
+        if (!retryable || attempt >= recovery_.max_retries)
+            break;
+
+        // 退避期间不持有总线
+        TickType_t ticks = pdMS_TO_TICKS(backoff_ms);
+        vTaskDelay(ticks > 0 ? ticks : 1);
+        backoff_ms = backoff_ms * 2 > recovery_.backoff_max_ms ? recovery_.backoff_max_ms
+                                                               : backoff_ms * 2;
+    }
+    OnFailure(ret);
+    return ret;
+}
+
+void I2cDevice::OnFailure(esp_err_t err)
+{
+    consecutive_failures_++;
+    if (recovery_.quarantine_threshold == 0 ||
+        consecutive_failures_ < recovery_.quarantine_threshold)
+        return;
+
+    uint32_t duration_ms = recovery_.quarantine_ms << quarantine_level_;
+    if (quarantine_level_ < 3)
+        quarantine_level_++;
+    quarantine_until_us_ = esp_timer_get_time() + (int64_t)duration_ms * 1000;
+    logger_.Warning("Quarantined for %u ms after %u failures (last: %s)", (unsigned)duration_ms,
+                    (unsigned)consecutive_failures_, esp_err_to_name(err));
+}
+
+bool I2cDevice::IsQuarantined() const
+{
+    return quarantine_until_us_ != 0 && esp_timer_get_time() < quarantine_until_us_;
+}
+
+void I2cDevice::ClearQuarantine()
+{
+    quarantine_until_us_ = 0;
+    quarantine_level_ = 0;
+    consecutive_failures_ = 0;
+}
+
+esp_err_t I2cDevice::RegisterCallbacks()
+{
+    i2c_master_event_callbacks_t cbs = {};
+    cbs.on_trans_done = OnTransDone;
+    return i2c_master_register_event_callbacks(dev_handle_, &cbs, this);
+}
+
+bool I2cDevice::SetSpeed(uint32_t speed_hz, int timeout_ms)
+{
+    if (dev_handle_ == nullptr)
+        return false;
+    if (speed_hz == config_.scl_speed_hz)
+        return true;
+
+    if (!bus_->Acquire(priority_, timeout_ms))
+    {
+        logger_.Error("Set speed: bus busy");
+        return false;
+    }
+    if (async_)
+    {
+        i2c_master_bus_wait_all_done(bus_handle_, timeout_ms);
+    }
+
+    i2c_device_config_t config = config_;
+    config.scl_speed_hz = speed_hz;
+    esp_err_t ret = i2c_master_bus_rm_device(dev_handle_);
+    if (ret == ESP_OK)
+    {
+        dev_handle_ = nullptr;
+        ret = i2c_master_bus_add_device(bus_handle_, &config, &dev_handle_);
+        if (ret == ESP_OK)
+        {
+            config_ = config;
+        }
+        else
+        {
+            // 回退到原频率, 保证设备仍然可用
+            i2c_master_bus_add_device(bus_handle_, &config_, &dev_handle_);
+        }
+        if (dev_handle_ != nullptr && async_)
+        {
+            RegisterCallbacks();
+        }
+    }
+    bus_->Release();
+
+    if (ret != ESP_OK)
+    {
+        logger_.Error("Failed to set speed %u Hz: %s", (unsigned)speed_hz, esp_err_to_name(ret));
+        return false;
+    }
+    logger_.Info("Speed set to %u Hz", (unsigned)speed_hz);
+    return true;
+}
+
+bool I2cDevice::Submit(const Op& op, I2cCompletion& done, int timeout_ms)
+{
+    if (dev_handle_ == nullptr)
+    {
+        done.Fail(ESP_ERR_INVALID_STATE);
+        return false;
+    }
+    if (!done.Done())
+    {
+        // 不能改写在途句柄的结果
+        logger_.Error("Completion still in flight");
+        return false;
+    }
+
+    if (!async_)
+    {
+        done.Arm();
+        done.Complete(Run(op, timeout_ms), false);
+        return true;
+    }
+
+    DrainCompleted();
+    if (IsQuarantined())
+    {
+        done.Fail(ESP_ERR_NOT_ALLOWED);
+        return false;
+    }
+    return Enqueue(op, done, timeout_ms, true);
+}
+
+bool I2cDevice::Enqueue(const Op& op, I2cCompletion& done, int timeout_ms, bool record)
+{
+    // 入队与驱动提交必须原子完成, 否则队列顺序会与总线完成顺序不一致
+    TickType_t ticks = timeout_ms < 0 ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms);
+    if (xSemaphoreTake(submit_lock_, ticks) != pdTRUE)
+    {
+        done.Fail(ESP_ERR_TIMEOUT);
+        return false;
+    }
+
+    Pending entry = {&done, record, BusTraceKind::I2cWrite, 0, 0, 0};
+    if (record)
+    {
+        DescribeOp(op, entry.kind, entry.reg);
+        entry.bytes = (uint32_t)OpBytes(op);
+        entry.start_us = esp_timer_get_time();
+    }
+
+    done.Arm();
+    bool queued = false;
+    taskENTER_CRITICAL(&pending_lock_);
+    if (pending_count_ < kMaxPending)
+    {
+        pending_[(pending_head_ + pending_count_) % kMaxPending] = entry;
+        pending_count_++;
+        queued = true;
+    }
+    taskEXIT_CRITICAL(&pending_lock_);
+
+    if (!queued)
+    {
+        xSemaphoreGive(submit_lock_);
+        done.Fail(ESP_ERR_NO_MEM);
+        logger_.Error("Too many pending transfers (max %d)", (int)kMaxPending);
+        return false;
+    }
+
+    esp_err_t ret = Dispatch(op, timeout_ms);
+    if (ret != ESP_OK)
+    {
+        // 驱动未接收该传输, 撤回刚入队的句柄
+        taskENTER_CRITICAL(&pending_lock_);
+        pending_count_--;
+        taskEXIT_CRITICAL(&pending_lock_);
+        done.Fail(ret);
+    }
+    xSemaphoreGive(submit_lock_);
+    return ret == ESP_OK;
+}
+
+bool I2cDevice::Withdraw(I2cCompletion& done)
+{
+    // 队列位置保留, 之后的完成事件按顺序弹出它而不再访问 done
+    bool found = false;
+    taskENTER_CRITICAL(&pending_lock_);
+    for (size_t i = 0; i < pending_count_; i++)
+    {
+        Pending& entry = pending_[(pending_head_ + i) % kMaxPending];
+        if (entry.done == &done)
+        {
+            entry.done = nullptr;
+            found = true;
+        }
+    }
+    taskEXIT_CRITICAL(&pending_lock_);
+    return found;
+}
+
+void I2cDevice::DrainCompleted()
+{
+    for (;;)
+    {
+        Completed item;
+        taskENTER_CRITICAL(&pending_lock_);
+        bool any = completed_count_ > 0;
+        if (any)
+        {
+            item = completed_[0];
+            completed_count_--;
+            memmove(&completed_[0], &completed_[1], completed_count_ * sizeof(Completed));
+        }
+        taskEXIT_CRITICAL(&pending_lock_);
+        if (!any)
+            return;
+
+        RecordOp(item.kind, item.reg, item.bytes, item.result, item.start_us, item.duration_us);
+        if (item.result == ESP_OK)
+        {
+            consecutive_failures_ = 0;
+            quarantine_level_ = 0;
+        }
+        else
+        {
+            OnFailure(item.result);
+        }
+    }
+}
+
+bool IRAM_ATTR I2cDevice::OnTransDone(i2c_master_dev_handle_t,
+                                      const i2c_master_event_data_t* event,
+                                      void* user_ctx)
+{
+    I2cDevice* self = static_cast<I2cDevice*>(user_ctx);
+    esp_err_t result = ESP_OK;
+    if (event->event == I2C_EVENT_NACK)
+    {
+        result = ESP_FAIL;
+    }
+    else if (event->event == I2C_EVENT_TIMEOUT)
+    {
+        result = ESP_ERR_TIMEOUT;
+    }
+
+    I2cCompletion* done = nullptr;
+    int64_t now = esp_timer_get_time();
+    taskENTER_CRITICAL_ISR(&self->pending_lock_);
+    if (self->pending_count_ > 0)
+    {
+        const Pending& entry = self->pending_[self->pending_head_];
+        done = entry.done;
+        // 提交前已 DrainCompleted, 登记数不会超过在途数
+        if (entry.record && self->completed_count_ < kMaxPending)
+        {
+            Completed& item = self->completed_[self->completed_count_++];
+            item.kind = entry.kind;
+            item.reg = entry.reg;
+            item.bytes = entry.bytes;
+            item.result = result;
+            item.start_us = entry.start_us;
+            item.duration_us = (uint32_t)(now - entry.start_us);
+        }
+        self->pending_head_ = (self->pending_head_ + 1) % kMaxPending;
+        self->pending_count_--;
+    }
+    taskEXIT_CRITICAL_ISR(&self->pending_lock_);
+
+    return done != nullptr && done->Complete(result, true);
+}
+
+bool I2cDevice::PrepareTransaction(I2cTransaction& txn)
+{
+    if (txn.Overflow())
+    {
+        logger_.Error("Transaction overflow (max %d ops, %d bytes)", (int)I2cTransaction::kMaxOps,
+                      (int)I2cTransaction::kBufferSize);
+        return false;
+    }
+    if (address_ > 0x7F)
+    {
+        logger_.Error("Transaction requires a 7-bit address");
+        return false;
+    }
+
+    txn.addr_bytes_[0] = (uint8_t)(address_ << 1);
+    txn.addr_bytes_[1] = (uint8_t)((address_ << 1) | 0x01);
+
+    // Reserve 已保证 STOP 有空位; STOP 不计入 op_count_, 事务可继续追加或再次提交
+    i2c_operation_job_t& stop = txn.ops_[txn.op_count_];
+    stop = {};
+    stop.command = I2C_MASTER_CMD_STOP;
+    return true;
+}
+
+bool I2cDevice::Execute(I2cTransaction& txn, int timeout_ms)
+{
+    if (dev_handle_ == nullptr)
+        return false;
+    if (txn.Empty())
+        return true;
+    if (!PrepareTransaction(txn))
+        return false;
+
+    esp_err_t ret =
+        Run({OpKind::Execute, nullptr, 0, nullptr, 0, txn.ops_, txn.op_count_ + 1}, timeout_ms);
+    if (ret != ESP_OK)
+    {
+        logger_.Error("Transaction failed (%d segments): %s", (int)txn.segments_,
+                      esp_err_to_name(ret));
+        reg_cache_.Invalidate();
+        return false;
+    }
+
+    for (size_t i = 0; i < txn.segments_; i++)
+    {
+        const I2cTransaction::Segment& seg = txn.segs_[i];
+        if (seg.wide || (seg.read && seg.len > 1))
+            continue;
+        CacheStore(seg.reg, seg.data, seg.len);
+    }
+    return true;
+}
+
+// --- I2cDevice async ---
+
+bool I2cDevice::WriteAsync(const uint8_t* data, size_t length, I2cCompletion& done, int timeout_ms)
+{
+    return Submit({OpKind::Transmit, data, length, nullptr, 0, nullptr, 0}, done, timeout_ms);
+}
+
+bool I2cDevice::ReadAsync(uint8_t* data, size_t length, I2cCompletion& done, int timeout_ms)
+{
+    return Submit({OpKind::Receive, nullptr, 0, data, length, nullptr, 0}, done, timeout_ms);
+}
+
+bool I2cDevice::WriteReadAsync(const uint8_t* write_data,
+                               size_t write_length,
+                               uint8_t* read_data,
+                               size_t read_length,
+                               I2cCompletion& done,
+                               int timeout_ms)
+{
+    return Submit({OpKind::TransmitReceive, write_data, write_length, read_data, read_length,
+                   nullptr, 0},
+                  done, timeout_ms);
+}
+
+bool I2cDevice::WriteReg8Async(uint8_t reg_addr, uint8_t data, I2cCompletion& done, int timeout_ms)
+{
+    if (!done.Done())
+        return false;
+    done.scratch_[0] = reg_addr;
+    done.scratch_[1] = data;
+    reg_cache_.Invalidate(reg_addr, reg_addr);
+    return WriteAsync(done.scratch_, 2, done, timeout_ms);
+}
+
+bool I2cDevice::ReadRegAsync(uint8_t reg_addr,
+                             uint8_t* data,
+                             size_t len,
+                             I2cCompletion& done,
+                             int timeout_ms)
+{
+    if (!done.Done())
+        return false;
+    done.scratch_[0] = reg_addr;
+    return WriteReadAsync(done.scratch_, 1, data, len, done, timeout_ms);
+}
+
+bool I2cDevice::ExecuteAsync(I2cTransaction& txn, I2cCompletion& done, int timeout_ms)
+{
+    if (txn.Empty() || !PrepareTransaction(txn))
+        return false;
+    for (size_t i = 0; i < txn.segments_; i++)
+    {
+        const I2cTransaction::Segment& seg = txn.segs_[i];
+        if (!seg.read)
+        {
+            size_t last = seg.reg + seg.len - 1;
+            reg_cache_.Invalidate(seg.reg, last > 0xFF ? 0xFF : (uint8_t)last);
+        }
+    }
+    return Submit({OpKind::Execute, nullptr, 0, nullptr, 0, txn.ops_, txn.op_count_ + 1}, done,
+                  timeout_ms);
+}
+
+// --- I2cDevice register cache ---
+
+void I2cDevice::CacheRegisters(uint8_t first_reg, uint8_t last_reg)
+{
+    reg_cache_.Cache(first_reg, last_reg);
+}
+
+void I2cDevice::MarkVolatile(uint8_t first_reg, uint8_t last_reg)
+{
+    reg_cache_.MarkVolatile(first_reg, last_reg);
+}
+
+void I2cDevice::InvalidateCache() { reg_cache_.Invalidate(); }
+
+void I2cDevice::InvalidateCache(uint8_t first_reg, uint8_t last_reg)
+{
+    reg_cache_.Invalidate(first_reg, last_reg);
+}
+
+bool I2cDevice::RefreshCache(int timeout_ms)
+{
+    if (dev_handle_ == nullptr)
+        return false;
+
+    reg_cache_.Invalidate();
+
+    // 每个连续可缓存区间依赖器件的地址自增, 按块一次读出; 缓冲区很小, 可在任意驱动任务中调用
+    uint8_t chunk[32];
+    int reg = 0;
+    while (reg < 256)
+    {
+        if (!reg_cache_.IsCacheable((uint8_t)reg))
+        {
+            reg++;
+            continue;
+        }
+        size_t len = 1;
+        while (reg + len < 256 && len < sizeof(chunk) &&
+               reg_cache_.IsCacheable((uint8_t)(reg + len)))
+        {
+            len++;
+        }
+        if (!ReadRegBytes((uint8_t)reg, std::span<uint8_t>(chunk, len), timeout_ms))
+            return false;
+        for (size_t i = 0; i < len; i++)
+        {
+            reg_cache_.Update((uint8_t)(reg + i), chunk[i]);
+        }
+        reg += (int)len;
+    }
+    return true;
+}
+
+void I2cDevice::CacheStore(uint8_t reg_addr, const uint8_t* data, size_t len)
+{
+    if (len == 1)
+    {
+        reg_cache_.Update(reg_addr, data[0]);
+    }
+    else if (len > 1)
+    {
+        // 多字节访问依赖器件的地址自增行为, 只做失效处理
+        size_t last = reg_addr + len - 1;
+        reg_cache_.Invalidate(reg_addr, last > 0xFF ? 0xFF : (uint8_t)last);
+    }
+}
+
+bool I2cDevice::WriteBytes(const std::vector<uint8_t>& data, int timeout_ms)
+{
+    return WriteBytes(std::span<const uint8_t>(data), timeout_ms);
+}
+
+bool I2cDevice::ReadBytes(std::vector<uint8_t>& data, size_t len, int timeout_ms)
+{
+    if (dev_handle_ == nullptr)
+        return false;
+    data.resize(len);
+    return ReadBytes(std::span<uint8_t>(data), timeout_ms);
+}
+
+bool I2cDevice::WriteReadBytes(const std::vector<uint8_t>& write_data,
+                               std::vector<uint8_t>& read_data,
+                               size_t read_len,
+                               int timeout_ms)
+{
+    if (dev_handle_ == nullptr)
+        return false;
+    read_data.resize(read_len);
+    return WriteReadBytes(std::span<const uint8_t>(write_data), std::span<uint8_t>(read_data),
+                          timeout_ms);
+}
+
+bool I2cDevice::WriteByte(uint8_t data, int timeout_ms)
+{
+    if (dev_handle_ == nullptr)
+        return false;
+    return Transmit(&data, 1, timeout_ms) == ESP_OK;
+}
+
+bool I2cDevice::ReadByte(uint8_t& data, int timeout_ms)
+{
+    if (dev_handle_ == nullptr)
+        return false;
+    return Receive(&data, 1, timeout_ms) == ESP_OK;
+}
+
+bool I2cDevice::WriteBytes(std::span<const uint8_t> data, int timeout_ms)
+{
+    if (dev_handle_ == nullptr)
+        return false;
+    return Transmit(data.data(), data.size(), timeout_ms) == ESP_OK;
+}
+
+bool I2cDevice::ReadBytes(std::span<uint8_t> data, int timeout_ms)
+{
+    if (dev_handle_ == nullptr)
+        return false;
+    return Receive(data.data(), data.size(), timeout_ms) == ESP_OK;
+}
+
+bool I2cDevice::WriteReadBytes(std::span<const uint8_t> write_data,
+                               std::span<uint8_t> read_data,
+                               int timeout_ms)
+{
+    if (dev_handle_ == nullptr)
+        return false;
+    return TransmitReceive(write_data.data(), write_data.size(), read_data.data(),
+                           read_data.size(), timeout_ms) == ESP_OK;
+}
+
+bool I2cDevice::WriteRegBytes(uint8_t reg_addr, const std::vector<uint8_t>& data, int timeout_ms)
+{
+    return WriteRegBytes(reg_addr, std::span<const uint8_t>(data), timeout_ms);
+}
+
+bool I2cDevice::ReadRegBytes(uint8_t reg_addr,
+                             std::vector<uint8_t>& data,
+                             size_t len,
+                             int timeout_ms)
+{
+    if (dev_handle_ == nullptr)
+        return false;
+    data.resize(len);
+    return ReadRegBytes(reg_addr, std::span<uint8_t>(data), timeout_ms);
+}
+
+bool I2cDevice::WriteRegBytes(uint8_t reg_addr, std::span<const uint8_t> data, int timeout_ms)
+{
+    if (dev_handle_ == nullptr)
+        return false;
+
+    if (data.empty())
+        return Transmit(&reg_addr, 1, timeout_ms) == ESP_OK;
+
+    // 寄存器地址与数据作为两段缓冲区在同一次 START/STOP 内发出, 无需拼接拷贝.
+    // 驱动只读取 write_buffer, 去掉 const 是接口限制.
+    i2c_master_transmit_multi_buffer_info_t buffers[2] = {
+        {&reg_addr, 1},
+        {const_cast<uint8_t*>(data.data()), data.size()},
+    };
+    if (Run({OpKind::MultiTransmit, nullptr, 0, nullptr, 0, nullptr, 2, buffers}, timeout_ms) !=
+        ESP_OK)
+        return false;
+    CacheStore(reg_addr, data.data(), data.size());
+    return true;
+}
+
+bool I2cDevice::ReadRegBytes(uint8_t reg_addr, std::span<uint8_t> data, int timeout_ms)
+{
+    if (dev_handle_ == nullptr)
+        return false;
+    return TransmitReceive(&reg_addr, 1, data.data(), data.size(), timeout_ms) == ESP_OK;
+}
+
+bool I2cDevice::ReadBlock(uint16_t reg_addr, std::span<uint8_t> data, int timeout_ms)
+{
+    if (dev_handle_ == nullptr)
+        return false;
+    if (reg_addr_mode_ == I2cRegAddr::Bits8)
+    {
+        if (reg_addr > 0xFF)
+        {
+            logger_.Error("Register 0x%04X exceeds 8-bit address mode", reg_addr);
+            return false;
+        }
+        return ReadRegBytes((uint8_t)reg_addr, data, timeout_ms);
+    }
+
+    uint8_t reg[2];
+    size_t reg_len = I2cTransaction::EncodeReg(reg_addr, reg_addr_mode_, reg);
+    return TransmitReceive(reg, reg_len, data.data(), data.size(), timeout_ms) == ESP_OK;
+}
+
+bool I2cDevice::WriteBlock(uint16_t reg_addr, std::span<const uint8_t> data, int timeout_ms)
+{
+    if (dev_handle_ == nullptr)
+        return false;
+    if (reg_addr_mode_ == I2cRegAddr::Bits8)
+    {
+        if (reg_addr > 0xFF)
+        {
+            logger_.Error("Register 0x%04X exceeds 8-bit address mode", reg_addr);
+            return false;
+        }
+        return WriteRegBytes((uint8_t)reg_addr, data, timeout_ms);
+    }
+
+    uint8_t reg[2];
+    size_t reg_len = I2cTransaction::EncodeReg(reg_addr, reg_addr_mode_, reg);
+    if (data.empty())
+        return Transmit(reg, reg_len, timeout_ms) == ESP_OK;
+    i2c_master_transmit_multi_buffer_info_t buffers[2] = {
+        {reg, reg_len},
+        {const_cast<uint8_t*>(data.data()), data.size()},
+    };
+    return Run({OpKind::MultiTransmit, nullptr, 0, nullptr, 0, nullptr, 2, buffers}, timeout_ms) ==
+           ESP_OK;
+}
+
+bool I2cDevice::ReadScatter(std::span<const I2cRegRead> reads, int timeout_ms)
+{
+    if (dev_handle_ == nullptr)
+        return false;
+
+    I2cTransaction txn;
+    for (size_t i = 0; i < reads.size(); i++)
+    {
+        if (!txn.ReadRegBytes(reads[i].reg, reg_addr_mode_, reads[i].data, reads[i].len))
+        {
+            logger_.Error("Scatter read: segment %u of %u rejected (empty or transaction full)",
+                          (unsigned)i, (unsigned)reads.size());
+            return false;
+        }
+    }
+    return Execute(txn, timeout_ms);
+}
+
+bool I2cDevice::WriteReg8(uint8_t reg_addr, uint8_t data, int timeout_ms)
+{
+    if (dev_handle_ == nullptr)
+        return false;
+    uint8_t buffer[2] = {reg_addr, data};
+    if (Transmit(buffer, 2, timeout_ms) != ESP_OK)
+        return false;
+    reg_cache_.Update(reg_addr, data);
+    return true;
+}
+
+bool I2cDevice::ReadReg8(uint8_t reg_addr, uint8_t& data, int timeout_ms)
+{
+    if (dev_handle_ == nullptr)
+        return false;
+    if (reg_cache_.Lookup(reg_addr, data))
+        return true;
+    if (TransmitReceive(&reg_addr, 1, &data, 1, timeout_ms) != ESP_OK)
+        return false;
+    reg_cache_.Update(reg_addr, data);
+    return true;
+}
+
+bool I2cDevice::WriteReg16(uint8_t reg_addr, uint16_t data, int timeout_ms)
+{
+    if (dev_handle_ == nullptr)
+        return false;
+    // Big Endian
+    uint8_t buffer[3] = {reg_addr, (uint8_t)(data >> 8), (uint8_t)(data & 0xFF)};
+    if (Transmit(buffer, 3, timeout_ms) != ESP_OK)
+        return false;
+    CacheStore(reg_addr, buffer + 1, 2);
+    return true;
+}
+
+bool I2cDevice::ReadReg16(uint8_t reg_addr, uint16_t& data, int timeout_ms)
+{
+    if (dev_handle_ == nullptr)
+        return false;
+    uint8_t buffer[2];
+    esp_err_t ret = TransmitReceive(&reg_addr, 1, buffer, 2, timeout_ms);
+    if (ret == ESP_OK)
+    {
+        data = ((uint16_t)buffer[0] << 8) | buffer[1];  // Big Endian
+        return true;
+    }
+    return false;
+}
+
+bool I2cDevice::WriteReg32(uint8_t reg_addr, uint32_t data, int timeout_ms)
+{
+    if (dev_handle_ == nullptr)
+        return false;
+    // Big Endian
+    uint8_t buffer[5] = {reg_addr, (uint8_t)(data >> 24), (uint8_t)(data >> 16),
+                         (uint8_t)(data >> 8), (uint8_t)(data & 0xFF)};
+    if (Transmit(buffer, 5, timeout_ms) != ESP_OK)
+        return false;
+    CacheStore(reg_addr, buffer + 1, 4);
+    return true;
 }
 
 bool I2cDevice::ReadReg32(uint8_t reg_addr, uint32_t& data, int timeout_ms)
@@ -367,7 +1668,7 @@ bool I2cDevice::ReadReg32(uint8_t reg_addr, uint32_t& data, int timeout_ms)
     if (dev_handle_ == nullptr)
         return false;
     uint8_t buffer[4];
-    esp_err_t ret = i2c_master_transmit_receive(dev_handle_, &reg_addr, 1, buffer, 4, timeout_ms);
+    esp_err_t ret = TransmitReceive(&reg_addr, 1, buffer, 4, timeout_ms);
     if (ret == ESP_OK)
     {
         data = ((uint32_t)buffer[0] << 24) | ((uint32_t)buffer[1] << 16) |
@@ -403,6 +1704,7 @@ bool I2cDevice::WriteRegBits(uint8_t reg_addr, uint8_t mask, uint8_t value, int
     if (dev_handle_ == nullptr)
         return false;
 
+    // 缓存命中时 ReadReg8 不访问总线, 只剩一次写
     uint8_t current_value;
     if (!ReadReg8(reg_addr, current_value, timeout_ms))
         return false;
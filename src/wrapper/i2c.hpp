@@ -1,7 +1,14 @@
 #pragma once
+#include <atomic>
+#include <span>
 #include <vector>
 #include "driver/i2c_master.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
 #include "wrapper/logger.hpp"
+#include "wrapper/bus-stats.hpp"
+#include "wrapper/bus-trace.hpp"
+#include "wrapper/register-cache.hpp"
 
 namespace wrapper
 {
@@ -32,11 +39,76 @@ struct I2cBusConfig : public i2c_master_bus_config_t
     }
 };
 
+/**
+ * @brief 总线调度优先级
+ *
+ * Interactive 设备 (触摸/键盘) 总是先于其它等待者获得总线, 最坏等待时间为
+ * 一次在途传输加上排在前面的 Interactive 传输. Normal/Background 等待者按
+ * aging 周期逐级提升, 最多提升到 Normal, 不会饿死但也不会抢占 Interactive.
+ */
+enum class I2cPriority : uint8_t
+{
+    Interactive = 0,
+    Normal = 1,
+    Background = 2,
+};
+
+/**
+ * @brief 7 位地址的 128 位在线位图
+ */
+struct I2cPresence
+{
+    uint32_t bits[4] = {};
+
+    bool Test(uint8_t addr) const { return addr < 0x80 && ((bits[addr >> 5] >> (addr & 31)) & 1u); }
+    void Set(uint8_t addr) { bits[addr >> 5] |= 1u << (addr & 31); }
+    size_t Count() const
+    {
+        return __builtin_popcount(bits[0]) + __builtin_popcount(bits[1]) +
+               __builtin_popcount(bits[2]) + __builtin_popcount(bits[3]);
+    }
+};
+
+/**
+ * @brief 已知器件签名
+ *
+ * id_reg < 0 表示仅凭地址匹配; 否则读取 id_reg 并比较 (value & id_mask) == id_value.
+ * 同一地址可有多条签名, 按表中顺序取第一条匹配项 (先列带 ID 校验的条目).
+ */
+struct I2cSignature
+{
+    uint8_t addr;
+    const char* name;
+    int16_t id_reg;
+    uint8_t id_mask;
+    uint8_t id_value;
+};
+
 class I2cBus
 {
     Logger& logger_;
     i2c_port_t port_;
     i2c_master_bus_handle_t bus_handle_;
+    bool async_;
+
+    // 调度器: 等待者节点位于等待任务的栈上
+    struct Waiter
+    {
+        I2cPriority priority;
+        int64_t enqueue_us;
+        bool granted;
+        SemaphoreHandle_t sem;
+        Waiter* next;
+    };
+
+    mutable portMUX_TYPE sched_lock_;
+    mutable bool sched_busy_;
+    mutable Waiter* sched_waiters_;
+    uint32_t aging_ms_;
+
+    // 总线汇总统计, 由挂在本总线上的设备在持有总线期间写入
+    mutable BusStats stats_;
+    mutable std::atomic<uint32_t> recoveries_;
 
     esp_err_t ProbeInternal(int addr);
 
@@ -47,6 +119,20 @@ class I2cBus
     Logger& GetLogger();
     i2c_port_t GetPort() const;
     i2c_master_bus_handle_t GetHandle() const;
+    // trans_queue_depth > 0 时驱动工作在异步模式
+    bool IsAsync() const { return async_; }
+
+    // 调度: 阻塞式设备传输前获取总线, 完成后释放
+    bool Acquire(I2cPriority priority, int timeout_ms) const;
+    void Release() const;
+    void SetAgingMs(uint32_t aging_ms) { aging_ms_ = aging_ms; }
+
+    // 统计 (CONFIG_WRAPPER_ESP32_BUS_STATS)
+    BusStats& GetStats() const { return stats_; }
+
+    // 总线卡死恢复: 调用方须已持有总线 (Acquire), 发送 SCL 时钟释放 SDA 并复位状态机
+    esp_err_t RecoverLocked() const;
+    uint32_t GetRecoveryCount() const { return recoveries_.load(); }
 
     // operations
     bool Init(const I2cBusConfig& config);
@@ -64,11 +150,32 @@ class I2cBus
     bool Scan(const std::vector<uint8_t>& addrs);
     bool Scan(int start_addr, int end_addr);
     bool Scan();
+
+    /**
+     * @brief 快速枚举, 结果写入位图而不打印
+     *
+     * 跳过保留地址 0x00-0x07 与 0x78-0x7F. 探测超时从 timeout_ms 起步, 遇到超时
+     * (时钟拉伸或总线卡死) 时加倍, 成功后复位; 连续 kMaxProbeTimeouts 次超时视为总线卡死并提前返回 false.
+     */
+    static constexpr int kMaxProbeTimeouts = 3;
+    bool Enumerate(I2cPresence& presence, int timeout_ms = 2);
+
+    // 按签名表识别在线器件, 每个地址最多输出一项, 返回写入 matches 的数量
+    size_t Identify(const I2cPresence& presence,
+                    std::span<const I2cSignature> table,
+                    std::span<const I2cSignature*> matches);
+    static std::span<const I2cSignature> KnownSignatures();
+
+    // 启动时使用: 快速枚举 + 已知签名识别, 每个在线器件输出一行日志
+    bool Detect();
 };
 
 struct I2cDeviceConfig : public i2c_device_config_t
 {
-    I2cDeviceConfig(uint8_t addr, uint32_t speed_hz) : i2c_device_config_t{}
+    I2cPriority priority;
+
+    I2cDeviceConfig(uint8_t addr, uint32_t speed_hz, I2cPriority prio = I2cPriority::Normal)
+        : i2c_device_config_t{}, priority(prio)
     {
         dev_addr_length = I2C_ADDR_BIT_LEN_7;
         device_address = addr;
@@ -78,11 +185,291 @@ struct I2cDeviceConfig : public i2c_device_config_t
     }
 };
 
+/**
+ * @brief 异步传输的完成句柄
+ *
+ * 由调用方持有, 在传输完成前必须保持有效. 三种等待方式可任选组合:
+ * OnComplete 回调 (ISR 上下文), NotifyTask 任务通知, 以及 Wait 阻塞等待.
+ */
+class I2cCompletion
+{
+   public:
+    using Callback = void (*)(esp_err_t result, void* arg);
+
+    I2cCompletion();
+    I2cCompletion(const I2cCompletion&) = delete;
+    I2cCompletion& operator=(const I2cCompletion&) = delete;
+
+    // 异步总线上回调在 ISR 上下文执行, 必须短小且 IRAM 安全
+    void OnComplete(Callback callback, void* arg);
+    // 完成时对指定任务调用 vTaskNotifyGiveFromISR; 通知只用于唤醒,
+    // 销毁本对象前须确认 Done() 或调用 Wait()
+    void NotifyTask(TaskHandle_t task);
+
+    bool Done() const { return done_.load(std::memory_order_acquire); }
+    esp_err_t Result() const { return result_; }
+    bool Wait(int timeout_ms);
+
+   private:
+    friend class I2cDevice;
+
+    std::atomic<bool> done_;
+    esp_err_t result_;
+    Callback callback_;
+    void* callback_arg_;
+    TaskHandle_t notify_task_;
+    StaticSemaphore_t sem_buffer_;
+    SemaphoreHandle_t sem_;
+    uint8_t scratch_[8];  // 寄存器地址与小数据的暂存区, 使调用方无需保留这些字节
+
+    void Arm();
+    void Fail(esp_err_t result);  // 提交失败: 只记录结果, 不触发回调与通知
+    bool Complete(esp_err_t result, bool from_isr);
+};
+
+// 寄存器地址宽度与字节序 (16 位地址按大端/小端发送)
+enum class I2cRegAddr : uint8_t
+{
+    Bits8 = 0,
+    Bits16Be = 1,
+    Bits16Le = 2,
+};
+
+// 分散读的一段: 从 reg 起自增读取 len 字节到 data
+struct I2cRegRead
+{
+    uint16_t reg;
+    uint8_t* data;
+    size_t len;
+};
+
+/**
+ * @brief 设备级故障恢复策略
+ *
+ * 失败时按错误码分类: 超时/总线状态错误视为总线卡死, 持有总线时执行 SCL clock-out
+ * (i2c_master_bus_reset) 后重试; NACK 仅重试. 重试之间释放总线并按指数退避等待,
+ * 邻居设备可在此期间使用总线. 连续失败达到 quarantine_threshold 次后隔离设备:
+ * 隔离期内调用立即返回 ESP_ERR_NOT_ALLOWED 且不访问总线; 到期后放行一次试探,
+ * 仍失败则隔离时间加倍 (上限 8 倍).
+ *
+ * 单次调用占用总线的上限为 (max_retries + 1) * timeout_ms 加恢复时间.
+ * 默认构造的策略不重试也不隔离, 与未启用时行为一致.
+ */
+struct I2cRecoveryPolicy
+{
+    uint8_t max_retries = 0;
+    uint16_t backoff_base_ms = 1;
+    uint16_t backoff_max_ms = 16;
+    bool bus_recovery = false;
+    uint8_t quarantine_threshold = 0;  // 0: 不隔离
+    uint32_t quarantine_ms = 1000;
+
+    // 共享总线上的推荐配置
+    static constexpr I2cRecoveryPolicy Standard()
+    {
+        I2cRecoveryPolicy policy;
+        policy.max_retries = 2;
+        policy.bus_recovery = true;
+        policy.quarantine_threshold = 5;
+        return policy;
+    }
+};
+
+/**
+ * @brief 批量寄存器事务
+ *
+ * 把多次寄存器读写排入同一个 i2c_operation_job_t 列表, 由 I2cDevice::Execute
+ * 一次提交给驱动: 段与段之间使用重复 START, 末尾只发一次 STOP.
+ * 写入数据会拷贝到内部缓冲区; 读取目标由调用方持有, 必须在 Execute 返回前保持有效.
+ *
+ * @note 对象约 1 KB (kMaxOps 个 job、段表与 kBufferSize 缓冲), 栈较小的任务中应声明为
+ *       static 或作为成员长期持有.
+ */
+class I2cTransaction
+{
+   public:
+    static constexpr size_t kMaxOps = 48;
+    static constexpr size_t kBufferSize = 64;
+
+    I2cTransaction();
+    I2cTransaction(const I2cTransaction&) = delete;
+    I2cTransaction& operator=(const I2cTransaction&) = delete;
+
+    void Clear();
+    size_t Size() const { return segments_; }
+    bool Empty() const { return segments_ == 0; }
+    bool Overflow() const { return overflow_; }
+
+    bool WriteReg8(uint8_t reg_addr, uint8_t data);
+    bool WriteRegBytes(uint8_t reg_addr, const uint8_t* data, size_t len);
+    bool ReadReg8(uint8_t reg_addr, uint8_t& data);
+    bool ReadRegBytes(uint8_t reg_addr, uint8_t* data, size_t len);
+
+    // 16 位寄存器地址; 这些段不参与 8 位影子缓存
+    bool WriteRegBytes(uint16_t reg_addr, I2cRegAddr mode, const uint8_t* data, size_t len);
+    bool ReadRegBytes(uint16_t reg_addr, I2cRegAddr mode, uint8_t* data, size_t len);
+
+    static size_t EncodeReg(uint16_t reg_addr, I2cRegAddr mode, uint8_t* out);
+
+   private:
+    friend class I2cDevice;
+
+    // 每段的寄存器信息, 供 Execute 成功后同步影子缓存
+    struct Segment
+    {
+        uint8_t reg;
+        bool read;
+        bool wide;
+        uint8_t* data;
+        size_t len;
+    };
+
+    i2c_operation_job_t ops_[kMaxOps];
+    Segment segs_[kMaxOps / 3];
+    size_t op_count_;
+    uint8_t buffer_[kBufferSize];
+    size_t buffer_used_;
+    size_t segments_;
+    bool overflow_;
+    uint8_t addr_bytes_[2];  // [0]: 写地址, [1]: 读地址, 由 Execute 填充
+
+    uint8_t* Stage(const uint8_t* data, size_t len);
+    bool Reserve(size_t ops, size_t bytes);
+    void PushStart();
+    void PushWrite(uint8_t* data, size_t len);
+    void PushRead(uint8_t* data, size_t len, bool last);
+};
+
 class I2cDevice
 {
+   public:
+    static constexpr size_t kMaxPending = 8;
+    // 阻塞调用超时后再等待硬件超时完成事件的余量
+    static constexpr int kCompletionGraceMs = 100;
+
+    struct WaitStats
+    {
+        uint32_t count;
+        uint64_t total_us;
+        uint32_t max_us;
+    };
+
    protected:
     Logger& logger_;
     i2c_master_dev_handle_t dev_handle_;
+    i2c_master_bus_handle_t bus_handle_;
+    const I2cBus* bus_;
+    i2c_device_config_t config_;
+    I2cPriority priority_;
+    WaitStats wait_stats_;
+    uint16_t address_;
+    I2cRegAddr reg_addr_mode_;
+    RegisterCache reg_cache_;
+
+    // 故障恢复
+    I2cRecoveryPolicy recovery_;
+    uint32_t consecutive_failures_;
+    uint8_t quarantine_level_;
+    int64_t quarantine_until_us_;
+    BusStats stats_;
+
+    // 异步模式: 按提交顺序排队的完成句柄, 由 ISR 依次弹出
+    struct Pending
+    {
+        I2cCompletion* done;  // 超时撤回后为空, ISR 只弹出不通知
+        bool record;          // 由完成 ISR 登记统计; RunOnce 的内部提交自行统计
+        BusTraceKind kind;
+        uint8_t reg;
+        uint32_t bytes;
+        int64_t start_us;  // 提交时间, 耗时含驱动队列中的等待
+    };
+    // ISR 中不能调用统计/追踪 (非 IRAM, 需任务级临界区), 只登记, 由 DrainCompleted 补记
+    struct Completed
+    {
+        BusTraceKind kind;
+        uint8_t reg;
+        uint32_t bytes;
+        esp_err_t result;
+        int64_t start_us;
+        uint32_t duration_us;
+    };
+    bool async_;
+    Pending pending_[kMaxPending];
+    size_t pending_head_;
+    size_t pending_count_;
+    Completed completed_[kMaxPending];
+    size_t completed_count_;
+    portMUX_TYPE pending_lock_;
+    StaticSemaphore_t submit_lock_buffer_;
+    SemaphoreHandle_t submit_lock_;
+
+    void CacheStore(uint8_t reg_addr, const uint8_t* data, size_t len);
+
+    // 所有驱动调用的唯一出口
+    enum class OpKind : uint8_t
+    {
+        Transmit,
+        Receive,
+        TransmitReceive,
+        MultiTransmit,
+        Execute,
+    };
+
+    struct Op
+    {
+        OpKind kind;
+        const uint8_t* tx;
+        size_t tx_len;
+        uint8_t* rx;
+        size_t rx_len;
+        i2c_operation_job_t* jobs;                                   // Execute
+        size_t job_count;                                            // jobs 或 buffers 的元素个数
+        i2c_master_transmit_multi_buffer_info_t* buffers = nullptr;  // MultiTransmit
+    };
+
+    esp_err_t Dispatch(const Op& op, int timeout_ms);
+    static size_t OpBytes(const Op& op);
+    static void DescribeOp(const Op& op, BusTraceKind& kind, uint8_t& reg);
+    void RecordOp(BusTraceKind kind,
+                  uint8_t reg,
+                  size_t bytes,
+                  esp_err_t ret,
+                  int64_t start_us,
+                  uint32_t duration_us);
+    esp_err_t Run(const Op& op, int timeout_ms);
+    esp_err_t RunOnce(const Op& op, int timeout_ms, bool& acquired);
+    void OnFailure(esp_err_t err);
+    // 公开异步接口的入口: 同步总线经 Run 执行, 异步总线检查隔离后入队
+    bool Submit(const Op& op, I2cCompletion& done, int timeout_ms);
+    bool Enqueue(const Op& op, I2cCompletion& done, int timeout_ms, bool record);
+    bool Withdraw(I2cCompletion& done);
+    void DrainCompleted();
+    esp_err_t RegisterCallbacks();
+    bool PrepareTransaction(I2cTransaction& txn);
+    static bool OnTransDone(i2c_master_dev_handle_t dev,
+                            const i2c_master_event_data_t* event,
+                            void* user_ctx);
+
+    esp_err_t Transmit(const uint8_t* data, size_t length, int timeout_ms)
+    {
+        return Run({OpKind::Transmit, data, length, nullptr, 0, nullptr, 0}, timeout_ms);
+    }
+
+    esp_err_t Receive(uint8_t* data, size_t length, int timeout_ms)
+    {
+        return Run({OpKind::Receive, nullptr, 0, data, length, nullptr, 0}, timeout_ms);
+    }
+
+    esp_err_t TransmitReceive(const uint8_t* write_data,
+                              size_t write_length,
+                              uint8_t* read_data,
+                              size_t read_length,
+                              int timeout_ms)
+    {
+        return Run({OpKind::TransmitReceive, write_data, write_length, read_data, read_length,
+                    nullptr, 0},
+                   timeout_ms);
+    }
 
    public:
     I2cDevice(Logger& logger);
@@ -91,14 +478,90 @@ class I2cDevice
     bool Init(const I2cBus& bus, const I2cDeviceConfig& config);
     bool Deinit();
 
+    uint16_t GetAddress() const { return address_; }
+
+    // 调度优先级与总线等待统计 (仅统计阻塞式调用)
+    void SetPriority(I2cPriority priority) { priority_ = priority; }
+    I2cPriority GetPriority() const { return priority_; }
+    const WaitStats& GetWaitStats() const { return wait_stats_; }
+    void ResetWaitStats() { wait_stats_ = {}; }
+
+    // 传输统计: 次数/字节/错误/超时与 log2 延迟直方图 (CONFIG_WRAPPER_ESP32_BUS_STATS).
+    // 异步传输在完成后的下一次调用或查询时计入
+    BusStatsSnapshot GetStats()
+    {
+        DrainCompleted();
+        return stats_.Snapshot();
+    }
+    void ResetStats()
+    {
+        DrainCompleted();
+        stats_.Reset();
+    }
+
+    // 运行时切换 SCL 频率: 仅重建本设备句柄, 总线与其它设备不受影响
+    bool SetSpeed(uint32_t speed_hz, int timeout_ms);
+    uint32_t GetSpeed() const { return config_.scl_speed_hz; }
+
+    // 一次驱动提交执行整个事务 (仅支持 7 位地址)
+    bool Execute(I2cTransaction& txn, int timeout_ms);
+
+    // 故障恢复策略与隔离状态
+    void SetRecoveryPolicy(const I2cRecoveryPolicy& policy) { recovery_ = policy; }
+    const I2cRecoveryPolicy& GetRecoveryPolicy() const { return recovery_; }
+    bool IsQuarantined() const;
+    void ClearQuarantine();
+    uint32_t GetConsecutiveFailures() const { return consecutive_failures_; }
+
+    // 寄存器地址模式: 作用于 ReadBlock/WriteBlock/ReadScatter, 8 位寄存器接口不受影响
+    void SetRegAddrMode(I2cRegAddr mode) { reg_addr_mode_ = mode; }
+    I2cRegAddr GetRegAddrMode() const { return reg_addr_mode_; }
+
+    // 按当前地址模式从 reg_addr 起自增读写整块数据, 直接使用调用方缓冲区
+    bool ReadBlock(uint16_t reg_addr, std::span<uint8_t> data, int timeout_ms);
+    bool WriteBlock(uint16_t reg_addr, std::span<const uint8_t> data, int timeout_ms);
+    // 多段不连续寄存器在一次 repeated-START 事务内读出, 仅一个 STOP.
+    // 内部在栈上构建 I2cTransaction (约 1 KB)
+    bool ReadScatter(std::span<const I2cRegRead> reads, int timeout_ms);
+
+    // 寄存器影子缓存: 仅对 CacheRegisters 声明的区间生效, 原始字节读写不经过缓存
+    void CacheRegisters(uint8_t first_reg, uint8_t last_reg);
+    void MarkVolatile(uint8_t first_reg, uint8_t last_reg);
+    void InvalidateCache();
+    void InvalidateCache(uint8_t first_reg, uint8_t last_reg);
+    // 按可缓存的连续区间分块 (至多 32 字节) 自增读取, 要求器件支持寄存器地址自增
+    bool RefreshCache(int timeout_ms);
+
+    // 异步接口: 返回 true 表示已提交, 结果通过 done 获取.
+    // 总线未开启队列 (trans_queue_depth == 0) 时退化为同步执行 (与阻塞接口相同, 经优先级调度、
+    // 重试与隔离), 返回前 done 已完成. 异步提交直接进入驱动队列, 不参与优先级调度;
+    // 隔离期内提交失败 (ESP_ERR_NOT_ALLOWED), 完成结果计入统计与连续失败计数.
+    // 缓冲区在完成前必须保持有效; 异步写会使对应寄存器的缓存失效.
+    bool IsAsync() const { return async_; }
+    bool WriteAsync(const uint8_t* data, size_t length, I2cCompletion& done, int timeout_ms);
+    bool ReadAsync(uint8_t* data, size_t length, I2cCompletion& done, int timeout_ms);
+    bool WriteReadAsync(const uint8_t* write_data,
+                        size_t write_length,
+                        uint8_t* read_data,
+                        size_t read_length,
+                        I2cCompletion& done,
+                        int timeout_ms);
+    bool WriteReg8Async(uint8_t reg_addr, uint8_t data, I2cCompletion& done, int timeout_ms);
+    bool ReadRegAsync(uint8_t reg_addr,
+                      uint8_t* data,
+                      size_t len,
+                      I2cCompletion& done,
+                      int timeout_ms);
+    bool ExecuteAsync(I2cTransaction& txn, I2cCompletion& done, int timeout_ms);
+
     inline bool WriteBytes(const uint8_t* data, size_t length, int timeout_ms)
     {
-        return i2c_master_transmit(dev_handle_, data, length, timeout_ms) == ESP_OK;
+        return Transmit(data, length, timeout_ms) == ESP_OK;
     }
 
     inline bool ReadBytes(uint8_t* data, size_t length, int timeout_ms)
     {
-        return i2c_master_receive(dev_handle_, data, length, timeout_ms) == ESP_OK;
+        return Receive(data, length, timeout_ms) == ESP_OK;
     }
 
     inline bool WriteReadBytes(const uint8_t* write_data,
@@ -107,13 +570,22 @@ class I2cDevice
                                size_t read_length,
                                int timeout_ms)
     {
-        return i2c_master_transmit_receive(dev_handle_, write_data, write_length, read_data,
-                                           read_length, timeout_ms) == ESP_OK;
+        return TransmitReceive(write_data, write_length, read_data, read_length, timeout_ms) ==
+               ESP_OK;
     }
 
     bool WriteByte(uint8_t data, int timeout_ms);
     bool ReadByte(uint8_t& data, int timeout_ms);
 
+    // span 接口: 调用方提供缓冲区 (含 std::array), 全路径无堆分配
+    bool WriteBytes(std::span<const uint8_t> data, int timeout_ms);
+    bool ReadBytes(std::span<uint8_t> data, int timeout_ms);
+    bool WriteReadBytes(std::span<const uint8_t> write_data,
+                        std::span<uint8_t> read_data,
+                        int timeout_ms);
+    bool WriteRegBytes(uint8_t reg_addr, std::span<const uint8_t> data, int timeout_ms);
+    bool ReadRegBytes(uint8_t reg_addr, std::span<uint8_t> data, int timeout_ms);
+
     bool WriteBytes(const std::vector<uint8_t>& data, int timeout_ms);
     bool ReadBytes(std::vector<uint8_t>& data, size_t len, int timeout_ms);
     bool WriteReadBytes(const std::vector<uint8_t>& write_data,
@@ -5,6 +5,7 @@
 #include "driver/i2s_tdm.h"
 #include "driver/i2s_pdm.h"
 #include "wrapper/logger.hpp"
+#include <span>
 #include <vector>
 
 #if ESP_IDF_VERSION_MAJOR >= 6
@@ -252,6 +253,24 @@ class I2sBus
     bool Write(const std::vector<uint8_t>& data, uint32_t timeout_ms = 1000);
     bool Read(std::vector<uint8_t>& dest, size_t size, uint32_t timeout_ms = 1000);
 
+    // span overloads: caller-owned buffers, no heap allocation
+    bool Write(std::span<const uint8_t> data, size_t& bytes_written, uint32_t timeout_ms = 1000)
+    {
+        return Write(data.data(), data.size_bytes(), bytes_written, timeout_ms);
+    }
+    bool Write(std::span<const int16_t> samples, size_t& bytes_written, uint32_t timeout_ms = 1000)
+    {
+        return Write(samples.data(), samples.size_bytes(), bytes_written, timeout_ms);
+    }
+    bool Read(std::span<uint8_t> dest, size_t& bytes_read, uint32_t timeout_ms = 1000)
+    {
+        return Read(dest.data(), dest.size_bytes(), bytes_read, timeout_ms);
+    }
+    bool Read(std::span<int16_t> samples, size_t& bytes_read, uint32_t timeout_ms = 1000)
+    {
+        return Read(samples.data(), samples.size_bytes(), bytes_read, timeout_ms);
+    }
+
     i2s_port_t GetPort() const { return port_; }
     i2s_chan_handle_t GetTxHandle() const { return tx_chan_handle_; }
     i2s_chan_handle_t GetRxHandle() const { return rx_chan_handle_; }
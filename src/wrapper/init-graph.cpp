@@ -0,0 +1,263 @@
+#include "wrapper/init-graph.hpp"
+#include "esp_timer.h"
+#include <cstdio>
+
+using namespace wrapper;
+
+static const char* StateName(InitGraph::StageState state)
+{
+    switch (state)
+    {
+        case InitGraph::StageState::Pending:
+            return "pending";
+        case InitGraph::StageState::Running:
+            return "running";
+        case InitGraph::StageState::Done:
+            return "ok";
+        case InitGraph::StageState::Failed:
+            return "FAILED";
+        case InitGraph::StageState::Skipped:
+            return "skipped";
+    }
+    return "?";
+}
+
+// --- InitGraph ---
+
+InitGraph::InitGraph(Logger& logger)
+    : logger_(logger), count_(0), workers_{}, run_start_us_(0), elapsed_us_(0), resolved_(0)
+{
+    exit_sem_ = xSemaphoreCreateCountingStatic(portNUM_PROCESSORS, 0, &exit_sem_buffer_);
+}
+
+InitGraph::~InitGraph() {}
+
+int InitGraph::AddStage(const char* name,
+                        std::function<bool()> func,
+                        std::initializer_list<int> deps,
+                        int core,
+                        bool optional)
+{
+    if (count_ == kMaxStages || func == nullptr)
+    {
+        logger_.Error("Cannot add stage %s (%u stages)", name, (unsigned)count_);
+        return -1;
+    }
+    uint32_t mask = 0;
+    for (int dep : deps)
+    {
+        // 只能依赖已添加的阶段, 保证无环
+        if (dep < 0 || dep >= (int)count_)
+        {
+            logger_.Error("Stage %s: invalid dependency %d", name, dep);
+            return -1;
+        }
+        mask |= 1u << dep;
+    }
+    if (core != kAnyCore && (core < 0 || core >= portNUM_PROCESSORS))
+    {
+        logger_.Warning("Stage %s: core %d not available, running on any core", name, core);
+        core = kAnyCore;
+    }
+
+    Stage& stage = stages_[count_];
+    stage.name = name;
+    stage.func = std::move(func);
+    stage.deps = mask;
+    stage.core = core;
+    stage.optional = optional;
+    stage.timing = {name, kAnyCore, 0, 0, StageState::Pending};
+    return (int)count_++;
+}
+
+InitGraph::StageTiming InitGraph::GetTiming(int id) const
+{
+    if (id < 0 || id >= (int)count_)
+        return {};
+    return stages_[id].timing;
+}
+
+// --- InitGraph scheduling ---
+
+int InitGraph::Claim(int core)
+{
+    // 跳过会级联, 重复扫描直到不再变化
+    bool changed = true;
+    while (changed)
+    {
+        changed = false;
+        for (size_t i = 0; i < count_; i++)
+        {
+            Stage& stage = stages_[i];
+            if (stage.timing.state != StageState::Pending)
+                continue;
+            for (size_t d = 0; d < i; d++)
+            {
+                StageState dep = stages_[d].timing.state;
+                if ((stage.deps & (1u << d)) &&
+                    (dep == StageState::Failed || dep == StageState::Skipped))
+                {
+                    stage.timing.state = StageState::Skipped;
+                    resolved_++;
+                    changed = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    for (size_t i = 0; i < count_; i++)
+    {
+        Stage& stage = stages_[i];
+        if (stage.timing.state != StageState::Pending)
+            continue;
+        if (stage.core != kAnyCore && stage.core != core)
+            continue;
+        bool ready = true;
+        for (size_t d = 0; d < i && ready; d++)
+        {
+            if ((stage.deps & (1u << d)) && stages_[d].timing.state != StageState::Done)
+                ready = false;
+        }
+        if (ready)
+        {
+            stage.timing.state = StageState::Running;
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+void InitGraph::NotifyWorkers()
+{
+    for (int core = 0; core < portNUM_PROCESSORS; core++)
+    {
+        if (workers_[core].task != nullptr)
+            xTaskNotifyGive(workers_[core].task);
+    }
+}
+
+void InitGraph::WorkerLoop(void* arg)
+{
+    Worker* worker = static_cast<Worker*>(arg);
+    InitGraph* self = worker->graph;
+
+    // 等 Run() 创建完全部工作任务后再开始领取
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    for (;;)
+    {
+        taskENTER_CRITICAL(&self->lock_);
+        int id = self->Claim(worker->core);
+        bool finished = self->resolved_ == self->count_;
+        taskEXIT_CRITICAL(&self->lock_);
+
+        if (id >= 0)
+        {
+            Stage& stage = self->stages_[id];
+            stage.timing.core = worker->core;
+            stage.timing.start_us = esp_timer_get_time() - self->run_start_us_;
+            bool ok = stage.func();
+            stage.timing.end_us = esp_timer_get_time() - self->run_start_us_;
+
+            taskENTER_CRITICAL(&self->lock_);
+            stage.timing.state = ok ? StageState::Done : StageState::Failed;
+            self->resolved_++;
+            taskEXIT_CRITICAL(&self->lock_);
+            if (!ok)
+            {
+                self->logger_.Error("Stage %s failed", stage.name);
+            }
+            self->NotifyWorkers();
+            continue;
+        }
+        if (finished)
+            break;
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+
+    // 自身不删除: 另一个工作任务可能仍在通知本任务, 由 Run() 收齐后统一删除
+    xSemaphoreGive(self->exit_sem_);
+    for (;;)
+    {
+        vTaskSuspend(nullptr);
+    }
+}
+
+bool InitGraph::Run(UBaseType_t priority, uint32_t stack_depth)
+{
+    for (size_t i = 0; i < count_; i++)
+    {
+        stages_[i].timing = {stages_[i].name, kAnyCore, 0, 0, StageState::Pending};
+    }
+    resolved_ = 0;
+    run_start_us_ = esp_timer_get_time();
+
+    int created = 0;
+    for (int core = 0; core < portNUM_PROCESSORS; core++)
+    {
+        Worker& worker = workers_[core];
+        worker.graph = this;
+        worker.core = core;
+        worker.task = nullptr;
+        char name[configMAX_TASK_NAME_LEN];
+        snprintf(name, sizeof(name), "init%d", core);
+        if (xTaskCreatePinnedToCore(&InitGraph::WorkerLoop, name, stack_depth, &worker, priority,
+                                    &worker.task, core) != pdPASS)
+        {
+            worker.task = nullptr;
+            logger_.Error("Failed to create init worker on core %d", core);
+            continue;
+        }
+        created++;
+    }
+    if (created == 0)
+        return false;
+    // 只绑定到缺失核心的阶段无法执行, 改为任意核心
+    for (size_t i = 0; i < count_; i++)
+    {
+        int core = stages_[i].core;
+        if (core != kAnyCore && workers_[core].task == nullptr)
+            stages_[i].core = kAnyCore;
+    }
+
+    NotifyWorkers();
+    for (int i = 0; i < created; i++)
+    {
+        xSemaphoreTake(exit_sem_, portMAX_DELAY);
+    }
+    // 每个工作任务的通知都发生在它释放 exit_sem_ 之前, 此时已无人再通知
+    for (Worker& worker : workers_)
+    {
+        if (worker.task != nullptr)
+            vTaskDelete(worker.task);
+        worker.task = nullptr;
+    }
+    elapsed_us_ = esp_timer_get_time() - run_start_us_;
+
+    bool ok = true;
+    for (size_t i = 0; i < count_; i++)
+    {
+        if (stages_[i].timing.state != StageState::Done && !stages_[i].optional)
+            ok = false;
+    }
+    return ok;
+}
+
+void InitGraph::PrintTimeline()
+{
+    logger_.Info("Init graph: %u stages in %lld ms", (unsigned)count_, elapsed_us_ / 1000);
+    for (size_t i = 0; i < count_; i++)
+    {
+        const StageTiming& t = stages_[i].timing;
+        if (t.state == StageState::Done || t.state == StageState::Failed)
+        {
+            logger_.Info("  %-12s core %d %6lld .. %6lld ms (%5lld ms) %s", t.name, t.core,
+                         t.start_us / 1000, t.end_us / 1000, (t.end_us - t.start_us) / 1000,
+                         StateName(t.state));
+        }
+        else
+        {
+            logger_.Info("  %-12s %s", t.name, StateName(t.state));
+        }
+    }
+}
@@ -0,0 +1,116 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "wrapper/logger.hpp"
+
+namespace wrapper
+{
+
+/**
+ * @brief 按依赖图并行执行的初始化阶段
+ *
+ * 每个阶段声明依赖的阶段与可运行的核心. Run() 在每个核心上各启动一个工作任务,
+ * 依赖全部成功的阶段由空闲的工作任务领取执行, 互不依赖的阶段 (如 SD 挂载、LVGL 初始化、
+ * 编解码器配置) 因而在两个核心上并发进行; 阶段内的阻塞等待 (面板复位、电源稳定) 也不再
+ * 占住整条初始化路径. 依赖失败的阶段被跳过.
+ *
+ * 阶段函数运行在工作任务中. I2cBus、SpiBus 的锁只保证单次传输互斥; 设备级的读-改-写
+ * (I2cDevice::WriteRegBits、esp_io_expander 的方向/电平设置等) 跨任务并不原子,
+ * 写同一设备寄存器的阶段须以依赖关系串行, 或把这些访问放进共同的前置阶段.
+ * 完成后 PrintTimeline() 输出每个阶段的核心、起止时间与结果.
+ *
+ * 对象约 2 KB (kMaxStages 个 std::function), 应放在堆上或静态存储, 不要放在 app_main 的栈上.
+ */
+class InitGraph
+{
+   public:
+    static constexpr size_t kMaxStages = 32;
+    static constexpr int kAnyCore = -1;
+
+    enum class StageState : uint8_t
+    {
+        Pending,
+        Running,
+        Done,
+        Failed,
+        Skipped,
+    };
+
+    struct StageTiming
+    {
+        const char* name;
+        int core;          // 实际运行的核心
+        int64_t start_us;  // 相对 Run() 开始
+        int64_t end_us;
+        StageState state;
+    };
+
+    InitGraph(Logger& logger);
+    ~InitGraph();
+
+    InitGraph(const InitGraph&) = delete;
+    InitGraph& operator=(const InitGraph&) = delete;
+
+    /**
+     * @brief 添加阶段, 返回阶段编号, 失败返回 -1
+     *
+     * deps 为已添加阶段的编号; core 为 kAnyCore 或核心号 (单核配置下忽略);
+     * optional 阶段失败不影响 Run() 的结果, 但依赖它的阶段仍被跳过.
+     */
+    int AddStage(const char* name,
+                 std::function<bool()> func,
+                 std::initializer_list<int> deps = {},
+                 int core = kAnyCore,
+                 bool optional = false);
+
+    // 阻塞直到全部阶段结束; 所有必需阶段成功时返回 true.
+    // stack_depth 为每个工作任务的栈字节数, 须容纳最深的阶段函数
+    bool Run(UBaseType_t priority = 5, uint32_t stack_depth = 4096);
+
+    size_t Count() const { return count_; }
+    StageTiming GetTiming(int id) const;
+    int64_t GetElapsedUs() const { return elapsed_us_; }
+    void PrintTimeline();
+
+   private:
+    struct Stage
+    {
+        const char* name;
+        std::function<bool()> func;
+        uint32_t deps;  // 依赖阶段的位图
+        int core;
+        bool optional;
+        StageTiming timing;
+    };
+
+    struct Worker
+    {
+        InitGraph* graph;
+        int core;
+        TaskHandle_t task;
+    };
+
+    Logger& logger_;
+    Stage stages_[kMaxStages];
+    size_t count_;
+    Worker workers_[portNUM_PROCESSORS];
+    int64_t run_start_us_;
+    int64_t elapsed_us_;
+    size_t resolved_;  // 已结束 (成功/失败/跳过) 的阶段数
+
+    portMUX_TYPE lock_ = portMUX_INITIALIZER_UNLOCKED;
+    StaticSemaphore_t exit_sem_buffer_;
+    SemaphoreHandle_t exit_sem_;
+
+    // 在锁内调用: 领取 core 上可运行的阶段, 顺带把依赖失败的阶段标记为跳过
+    int Claim(int core);
+    void NotifyWorkers();
+    static void WorkerLoop(void* arg);
+};
+
+}  // namespace wrapper
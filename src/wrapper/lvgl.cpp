@@ -2,16 +2,33 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "lvgl.h"
+#include "esp_timer.h"
+#include "wrapper/console.hpp"
+#include <cstring>
 
 using namespace wrapper;
 
+// 刷新等待事件自 LVGL 9.2 起提供
+#if LVGL_VERSION_MAJOR > 9 || (LVGL_VERSION_MAJOR == 9 && LVGL_VERSION_MINOR >= 2)
+#define WRAPPER_LVGL_FLUSH_WAIT_EVENTS 1
+#endif
+
 LvglPort::LvglPort(Logger& logger)
     : logger_(logger),
       lvgl_display_(NULL),
       lvgl_touch_(NULL),
       lvgl_encoder_(NULL),
       lvgl_group_(NULL),
-      initialized_(false)
+      initialized_(false),
+      display_(NULL),
+      refr_start_us_(0),
+      render_start_us_(0),
+      wait_start_us_(0),
+      frame_wait_us_(0),
+      frame_bytes_(0),
+      frame_rendered_(false),
+      overlay_(NULL),
+      overlay_timer_(NULL)
 {
 }
 
@@ -39,6 +56,18 @@ bool LvglPort::Init(const LvglPortConfig& config)
 
 bool LvglPort::Deinit()
 {
+    if (overlay_timer_ != NULL)
+    {
+        lv_timer_delete(overlay_timer_);
+        overlay_timer_ = NULL;
+    }
+
+    if (overlay_ != NULL)
+    {
+        lv_obj_delete(overlay_);
+        overlay_ = NULL;
+    }
+
     if (lvgl_encoder_ != NULL)
     {
         lv_indev_delete(lvgl_encoder_);
@@ -61,6 +90,7 @@ bool LvglPort::Deinit()
     {
         lvgl_port_remove_disp(lvgl_display_);
         lvgl_display_ = NULL;
+        display_ = NULL;
     }
 
     if (initialized_)
@@ -94,6 +124,14 @@ bool LvglPort::AddDisplay(const DisplayBase& display, LvglDisplayConfig& config)
         logger_.Warning("Display already added. Removing existing display first.");
         lvgl_port_remove_disp(lvgl_display_);
         lvgl_display_ = NULL;
+        display_ = NULL;
+    }
+
+    // 字节交换已由面板代理完成, LVGL 再交换一次会把颜色换回去
+    if (display.GetByteSwap() && config.flags.swap_bytes)
+    {
+        logger_.Warning("Display swaps bytes itself, disabling LVGL swap_bytes");
+        config.flags.swap_bytes = false;
     }
 
     // LvglDisplayConfig final_config = config;
@@ -107,6 +145,7 @@ bool LvglPort::AddDisplay(const DisplayBase& display, LvglDisplayConfig& config)
         return false;
     }
 
+    AttachMetrics(display);
     logger_.Info("LVGL display added");
 
     return true;
@@ -127,6 +166,7 @@ bool LvglPort::AddDisplayDsi(const DisplayBase& display,
         logger_.Warning("Display already added. Removing existing display first.");
         lvgl_port_remove_disp(lvgl_display_);
         lvgl_display_ = NULL;
+        display_ = NULL;
     }
 
     config.io_handle = display.GetIoHandle();
@@ -139,6 +179,7 @@ bool LvglPort::AddDisplayDsi(const DisplayBase& display,
         return false;
     }
 
+    AttachMetrics(display);
     logger_.Info("LVGL DSI display added");
     return true;
 }
@@ -465,3 +506,160 @@ bool LvglPort::SetRotation(lv_display_rotation_t rotation)
     logger_.Info("Display rotation set to %d degrees", rotation);
     return true;
 }
+
+// =============================================================================
+// 帧统计
+// =============================================================================
+
+void LvglPort::AttachMetrics(const DisplayBase& display)
+{
+    display_ = &display;
+    metrics_.Reset();
+    frame_rendered_ = false;
+    if (Lock(0))
+    {
+        lv_display_add_event_cb(lvgl_display_, OnDisplayEvent, LV_EVENT_ALL, this);
+        Unlock();
+    }
+}
+
+void LvglPort::OnDisplayEvent(lv_event_t* e)
+{
+    LvglPort* self = static_cast<LvglPort*>(lv_event_get_user_data(e));
+    int64_t now = esp_timer_get_time();
+
+    switch (lv_event_get_code(e))
+    {
+        case LV_EVENT_REFR_START:
+            self->refr_start_us_ = now;
+            self->frame_wait_us_ = 0;
+            self->frame_bytes_ = 0;
+            self->frame_rendered_ = false;
+            break;
+        case LV_EVENT_RENDER_START:
+            self->render_start_us_ = now;
+            self->frame_rendered_ = true;
+            break;
+        case LV_EVENT_FLUSH_START:
+        {
+            const lv_area_t* area = static_cast<const lv_area_t*>(lv_event_get_param(e));
+            lv_display_t* disp = static_cast<lv_display_t*>(lv_event_get_current_target(e));
+            uint32_t bpp = lv_color_format_get_bpp(lv_display_get_color_format(disp));
+            if (area != NULL)
+                self->frame_bytes_ += lv_area_get_size(area) * bpp / 8;
+            break;
+        }
+#ifdef WRAPPER_LVGL_FLUSH_WAIT_EVENTS
+        case LV_EVENT_FLUSH_WAIT_START:
+            self->wait_start_us_ = now;
+            break;
+        case LV_EVENT_FLUSH_WAIT_FINISH:
+            self->frame_wait_us_ += (uint32_t)(now - self->wait_start_us_);
+            break;
+#endif
+        case LV_EVENT_RENDER_READY:
+        {
+            uint32_t render_us = (uint32_t)(now - self->render_start_us_);
+            render_us = render_us > self->frame_wait_us_ ? render_us - self->frame_wait_us_ : 0;
+            self->metrics_.Add(FrameMetrics::kRenderUs, render_us);
+            break;
+        }
+        case LV_EVENT_REFR_READY:
+        {
+            // 没有脏区的刷新周期不计为帧
+            if (!self->frame_rendered_)
+                break;
+            uint32_t frame_us = (uint32_t)(now - self->refr_start_us_);
+            uint32_t dropped = frame_us / (LV_DEF_REFR_PERIOD * 1000);
+#ifdef WRAPPER_LVGL_FLUSH_WAIT_EVENTS
+            self->metrics_.Add(FrameMetrics::kFlushWaitUs, self->frame_wait_us_);
+#endif
+            self->metrics_.Add(FrameMetrics::kBytes, self->frame_bytes_);
+            self->metrics_.CountFrame(dropped);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+FrameMetricsSnapshot LvglPort::GetFrameMetrics() const
+{
+    FrameMetricsSnapshot snapshot = metrics_.Snapshot();
+    if (display_ != NULL)
+    {
+        snapshot.dma_us = display_->GetFrameMetrics().dma_us;
+    }
+    return snapshot;
+}
+
+// dma_us 为显示对象的滚动窗口, 不随之重置
+void LvglPort::ResetFrameMetrics() { metrics_.Reset(); }
+
+void LvglPort::OnOverlayTimer(lv_timer_t* timer)
+{
+    LvglPort* self = static_cast<LvglPort*>(lv_timer_get_user_data(timer));
+    FrameMetricsSnapshot s = self->GetFrameMetrics();
+    lv_label_set_text_fmt(self->overlay_,
+                          "%lu fps  drop %lu\nrender %lu/%lu us\nwait %lu/%lu us\ndma %lu/%lu us",
+                          (unsigned long)s.fps, (unsigned long)s.dropped,
+                          (unsigned long)s.render_us.avg, (unsigned long)s.render_us.p99,
+                          (unsigned long)s.flush_wait_us.avg, (unsigned long)s.flush_wait_us.p99,
+                          (unsigned long)s.dma_us.avg, (unsigned long)s.dma_us.p99);
+}
+
+bool LvglPort::ShowMetricsOverlay(bool show)
+{
+    if (lvgl_display_ == NULL)
+    {
+        logger_.Error("Display must be added before metrics overlay");
+        return false;
+    }
+    if (!Lock(0))
+    {
+        logger_.Error("Failed to acquire LVGL lock");
+        return false;
+    }
+
+    if (show && overlay_ == NULL)
+    {
+        overlay_ = lv_label_create(lv_display_get_layer_top(lvgl_display_));
+        lv_obj_set_style_bg_color(overlay_, lv_color_black(), 0);
+        lv_obj_set_style_bg_opa(overlay_, LV_OPA_60, 0);
+        lv_obj_set_style_text_color(overlay_, lv_color_white(), 0);
+        lv_obj_set_style_pad_all(overlay_, 2, 0);
+        lv_obj_align(overlay_, LV_ALIGN_TOP_LEFT, 0, 0);
+        lv_label_set_text(overlay_, "");
+        overlay_timer_ = lv_timer_create(OnOverlayTimer, 500, this);
+    }
+    else if (!show && overlay_ != NULL)
+    {
+        lv_timer_delete(overlay_timer_);
+        overlay_timer_ = NULL;
+        lv_obj_delete(overlay_);
+        overlay_ = NULL;
+    }
+
+    Unlock();
+    return true;
+}
+
+int LvglPort::MetricsCommand(void* context, int argc, char** argv)
+{
+    LvglPort* self = static_cast<LvglPort*>(context);
+    if (argc > 1 && strcmp(argv[1], "reset") == 0)
+    {
+        self->ResetFrameMetrics();
+        printf("frame metrics reset\n");
+        return 0;
+    }
+    FrameMetrics::Print(stdout, self->GetFrameMetrics());
+    return 0;
+}
+
+bool LvglPort::RegisterCommand(Console& console)
+{
+    return console.RegisterCommand(ConsoleCommand("fps", "Print LVGL frame time statistics",
+                                                  "[reset]", nullptr, nullptr, MetricsCommand,
+                                                  this));
+}
@@ -2,6 +2,7 @@
 
 #include "esp_lvgl_port.h"
 #include "wrapper/display.hpp"
+#include "wrapper/frame-metrics.hpp"
 #include "wrapper/touch.hpp"
 #include "wrapper/logger.hpp"
 #include "wrapper/encoder.hpp"
@@ -9,6 +10,8 @@
 namespace wrapper
 {
 
+class Console;
+
 struct LvglPortConfig : public lvgl_port_cfg_t
 {
     LvglPortConfig(int task_prio,
@@ -105,6 +108,23 @@ class LvglPort
     lv_group_t* lvgl_group_;    ///< 编码器使用的 LVGL 焦点组
     bool initialized_;
 
+    // --- 帧统计 ---
+    const DisplayBase* display_;  ///< 提供传输侧统计
+    FrameMetrics metrics_;
+    int64_t refr_start_us_;
+    int64_t render_start_us_;
+    int64_t wait_start_us_;
+    uint32_t frame_wait_us_;
+    uint32_t frame_bytes_;
+    bool frame_rendered_;
+    lv_obj_t* overlay_;
+    lv_timer_t* overlay_timer_;
+
+    void AttachMetrics(const DisplayBase& display);
+    static void OnDisplayEvent(lv_event_t* e);
+    static void OnOverlayTimer(lv_timer_t* timer);
+    static int MetricsCommand(void* context, int argc, char** argv);
+
    public:
     LvglPort(Logger& logger);
     ~LvglPort();
@@ -140,5 +160,20 @@ class LvglPort
     void Wake(lvgl_port_event_type_t event, void* pram);
     bool SetRotation(lv_display_rotation_t rotation);
     void Test(bool is_monochrome = false);
+
+    /**
+     * @brief 帧耗时统计
+     *
+     * 渲染侧来自 LVGL 显示事件: render_us 为渲染耗时 (LVGL >= 9.2 时扣除等待刷新),
+     * flush_wait_us 为等待上一块缓冲发送完成, bytes 为每帧刷新的像素字节,
+     * dropped 为单帧超过 LV_DEF_REFR_PERIOD 而错过的周期数. dma_us 取自 DisplayBase.
+     * 调整 LvglDisplayConfig 的 buffer_size / double_buffer / trans_size 时用于对比.
+     */
+    FrameMetricsSnapshot GetFrameMetrics() const;
+    void ResetFrameMetrics();
+    // 在顶层图层显示统计 (每 500 ms 更新; 自身的重绘也计入统计)
+    bool ShowMetricsOverlay(bool show);
+    // 注册 "fps [reset]" 控制台命令
+    bool RegisterCommand(Console& console);
 };
 }  // namespace wrapper
@@ -0,0 +1,256 @@
+#include "wrapper/pixel.hpp"
+#include <algorithm>
+#include <cstring>
+
+using namespace wrapper;
+
+// --- RGB565 byte swap ---
+
+static inline uint32_t Swap16x2(uint32_t v)
+{
+    return ((v & 0x00FF00FFu) << 8) | ((v >> 8) & 0x00FF00FFu);
+}
+
+static inline uint16_t Swap16(uint16_t v) { return (uint16_t)((v << 8) | (v >> 8)); }
+
+void PixelOps::SwapRgb565(uint16_t* dst, const uint16_t* src, size_t count)
+{
+    // 目标对齐到 4 字节后按字处理; 源与目标相对错位时只能逐像素
+    if (((uintptr_t)dst & 2) != 0 && count > 0)
+    {
+        *dst++ = Swap16(*src++);
+        count--;
+    }
+    if (((uintptr_t)src & 2) != 0)
+    {
+        for (size_t i = 0; i < count; i++)
+            dst[i] = Swap16(src[i]);
+        return;
+    }
+
+    uint32_t* d = reinterpret_cast<uint32_t*>(dst);
+    const uint32_t* s = reinterpret_cast<const uint32_t*>(src);
+    size_t words = count / 2;
+    size_t i = 0;
+    for (; i + 4 <= words; i += 4)
+    {
+        uint32_t a = s[i], b = s[i + 1], c = s[i + 2], e = s[i + 3];
+        d[i] = Swap16x2(a);
+        d[i + 1] = Swap16x2(b);
+        d[i + 2] = Swap16x2(c);
+        d[i + 3] = Swap16x2(e);
+    }
+    for (; i < words; i++)
+        d[i] = Swap16x2(s[i]);
+    if (count & 1)
+        dst[count - 1] = Swap16(src[count - 1]);
+}
+
+// --- RGB888 / ARGB8888 -> RGB565 ---
+
+void PixelOps::Rgb888ToRgb565(uint16_t* dst, const uint8_t* src, size_t count, bool swap)
+{
+    size_t i = 0;
+    // 两像素一组, 拼成一个 32 位字写出 (原地转换时写指针始终落后于读指针)
+    if (((uintptr_t)dst & 2) == 0)
+    {
+        uint32_t* d = reinterpret_cast<uint32_t*>(dst);
+        for (; i + 2 <= count; i += 2)
+        {
+            const uint8_t* p = src + i * 3;
+            uint32_t lo = Pack565(p[2], p[1], p[0]);
+            uint32_t hi = Pack565(p[5], p[4], p[3]);
+            uint32_t v = lo | (hi << 16);
+            d[i / 2] = swap ? Swap16x2(v) : v;
+        }
+    }
+    for (; i < count; i++)
+    {
+        const uint8_t* p = src + i * 3;
+        uint16_t v = Pack565(p[2], p[1], p[0]);
+        dst[i] = swap ? Swap16(v) : v;
+    }
+}
+
+// 0..65025 范围内精确的 round(x / 255)
+static inline uint32_t Div255(uint32_t x)
+{
+    x += 128;
+    return (x + (x >> 8)) >> 8;
+}
+
+void PixelOps::Argb8888ToRgb565(uint16_t* dst,
+                                const uint32_t* src,
+                                size_t count,
+                                uint16_t background,
+                                bool swap)
+{
+    // 背景展开到 8 位 (高位复制到低位)
+    uint32_t bg_r = ((background >> 11) & 0x1F) << 3;
+    uint32_t bg_g = ((background >> 5) & 0x3F) << 2;
+    uint32_t bg_b = (background & 0x1F) << 3;
+    bg_r |= bg_r >> 5;
+    bg_g |= bg_g >> 6;
+    bg_b |= bg_b >> 5;
+    uint16_t bg = swap ? Swap16(background) : background;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        uint32_t c = src[i];
+        uint32_t a = c >> 24;
+        uint16_t v;
+        if (a == 0xFF)
+        {
+            v = Pack565((uint8_t)(c >> 16), (uint8_t)(c >> 8), (uint8_t)c);
+        }
+        else if (a == 0)
+        {
+            dst[i] = bg;
+            continue;
+        }
+        else
+        {
+            uint32_t na = 255 - a;
+            uint32_t r = Div255(((c >> 16) & 0xFF) * a + bg_r * na);
+            uint32_t g = Div255(((c >> 8) & 0xFF) * a + bg_g * na);
+            uint32_t b = Div255((c & 0xFF) * a + bg_b * na);
+            v = Pack565((uint8_t)r, (uint8_t)g, (uint8_t)b);
+        }
+        dst[i] = swap ? Swap16(v) : v;
+    }
+}
+
+// --- 1 bpp page packing ---
+
+// 8x8 位矩阵转置 (Hacker's Delight 7-3). 输入 rows[0..7] 自上而下, 每字节 MSB 为最左像素;
+// 输出 cols[0..7] 自左而右, 每字节 bit0 为最上一行
+static inline void Transpose8(const uint8_t* rows, size_t stride, uint8_t* cols)
+{
+    // 行逆序装入, 使转置后的 MSB 对应最下一行
+    uint32_t x = ((uint32_t)rows[7 * stride] << 24) | ((uint32_t)rows[6 * stride] << 16) |
+                 ((uint32_t)rows[5 * stride] << 8) | rows[4 * stride];
+    uint32_t y = ((uint32_t)rows[3 * stride] << 24) | ((uint32_t)rows[2 * stride] << 16) |
+                 ((uint32_t)rows[1 * stride] << 8) | rows[0];
+    uint32_t t;
+    t = (x ^ (x >> 7)) & 0x00AA00AAu;
+    x = x ^ t ^ (t << 7);
+    t = (y ^ (y >> 7)) & 0x00AA00AAu;
+    y = y ^ t ^ (t << 7);
+    t = (x ^ (x >> 14)) & 0x0000CCCCu;
+    x = x ^ t ^ (t << 14);
+    t = (y ^ (y >> 14)) & 0x0000CCCCu;
+    y = y ^ t ^ (t << 14);
+    t = (x & 0xF0F0F0F0u) | ((y >> 4) & 0x0F0F0F0Fu);
+    y = ((x << 4) & 0xF0F0F0F0u) | (y & 0x0F0F0F0Fu);
+    x = t;
+    cols[0] = (uint8_t)(x >> 24);
+    cols[1] = (uint8_t)(x >> 16);
+    cols[2] = (uint8_t)(x >> 8);
+    cols[3] = (uint8_t)x;
+    cols[4] = (uint8_t)(y >> 24);
+    cols[5] = (uint8_t)(y >> 16);
+    cols[6] = (uint8_t)(y >> 8);
+    cols[7] = (uint8_t)y;
+}
+
+void PixelOps::PackPages(uint8_t* dst,
+                         const uint8_t* src,
+                         int width,
+                         int height,
+                         size_t src_stride)
+{
+    for (int page = 0; page < height / 8; page++)
+    {
+        const uint8_t* rows = src + (size_t)page * 8 * src_stride;
+        uint8_t* out = dst + (size_t)page * width;
+        for (int block = 0; block < width / 8; block++)
+        {
+            Transpose8(rows + block, src_stride, out + block * 8);
+        }
+    }
+}
+
+// --- Rotation / mirroring ---
+
+namespace
+{
+
+struct Pixel24
+{
+    uint8_t c[3];
+};
+
+// 目标下标 = base + i * step_i + j * step_j, (i, j) 为源像素的列与行
+template <typename T>
+void TransformTiled(
+    T* dst, const T* src, int width, int height, bool swap_xy, bool mirror_x, bool mirror_y)
+{
+    int dst_w = swap_xy ? height : width;
+    int dst_h = swap_xy ? width : height;
+    ptrdiff_t step_u = mirror_x ? -1 : 1;
+    ptrdiff_t step_v = mirror_y ? -(ptrdiff_t)dst_w : (ptrdiff_t)dst_w;
+    ptrdiff_t base = (mirror_x ? dst_w - 1 : 0) + (ptrdiff_t)(mirror_y ? dst_h - 1 : 0) * dst_w;
+    ptrdiff_t step_i = swap_xy ? step_v : step_u;
+    ptrdiff_t step_j = swap_xy ? step_u : step_v;
+
+    // 不交换轴时目标行连续, 逐行处理即可
+    if (!swap_xy)
+    {
+        for (int j = 0; j < height; j++)
+        {
+            const T* s = src + (size_t)j * width;
+            T* d = dst + base + j * step_j;
+            if (!mirror_x)
+            {
+                memcpy(d, s, sizeof(T) * width);
+                continue;
+            }
+            for (int i = 0; i < width; i++)
+                d[-i] = s[i];
+        }
+        return;
+    }
+
+    const int tile = PixelOps::kTile;
+    for (int tj = 0; tj < height; tj += tile)
+    {
+        int j_end = std::min(tj + tile, height);
+        for (int ti = 0; ti < width; ti += tile)
+        {
+            int i_end = std::min(ti + tile, width);
+            for (int j = tj; j < j_end; j++)
+            {
+                const T* s = src + (size_t)j * width;
+                T* d = dst + base + j * step_j;
+                for (int i = ti; i < i_end; i++)
+                    d[i * step_i] = s[i];
+            }
+        }
+    }
+}
+
+}  // namespace
+
+void PixelOps::Transform16(uint16_t* dst,
+                           const uint16_t* src,
+                           int width,
+                           int height,
+                           bool swap_xy,
+                           bool mirror_x,
+                           bool mirror_y)
+{
+    TransformTiled(dst, src, width, height, swap_xy, mirror_x, mirror_y);
+}
+
+void PixelOps::Transform24(uint8_t* dst,
+                           const uint8_t* src,
+                           int width,
+                           int height,
+                           bool swap_xy,
+                           bool mirror_x,
+                           bool mirror_y)
+{
+    static_assert(sizeof(Pixel24) == 3, "Pixel24 must be packed");
+    TransformTiled(reinterpret_cast<Pixel24*>(dst), reinterpret_cast<const Pixel24*>(src), width,
+                   height, swap_xy, mirror_x, mirror_y);
+}
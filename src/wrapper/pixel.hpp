@@ -0,0 +1,75 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace wrapper
+{
+
+/**
+ * @brief 像素格式转换与字节交换内核
+ *
+ * 全部为可移植 C++: 32 位 SWAR (一次处理两个 RGB565 像素) 加循环展开, 在 Xtensa/RISC-V
+ * 与主机上结果逐位一致; 没有 SIMD (ESP32-S3 PIE、SSE、NEON) 实现.
+ * 源与目标可以相同 (原地转换), 其余情况不得重叠.
+ *
+ * 字节顺序与 LVGL 一致: RGB888 为 B, G, R; ARGB8888 按小端 uint32 读取为 0xAARRGGBB.
+ * swap 参数为 true 时输出大端 RGB565 (SPI 面板的线序).
+ */
+class PixelOps
+{
+   public:
+    // RGB565 高低字节交换
+    static void SwapRgb565(uint16_t* dst, const uint16_t* src, size_t count);
+
+    static void Rgb888ToRgb565(uint16_t* dst, const uint8_t* src, size_t count, bool swap);
+
+    // 按 alpha 与 background (本机字节序 RGB565) 混合, 结果四舍五入
+    static void Argb8888ToRgb565(uint16_t* dst,
+                                 const uint32_t* src,
+                                 size_t count,
+                                 uint16_t background,
+                                 bool swap);
+
+    /**
+     * @brief 行优先 1 bpp (MSB 为最左像素, LVGL I1 去掉调色板后的数据) 转 SSD1306 页格式
+     *
+     * dst 每页 width 字节, 每字节为一列的 8 个像素, bit0 为页内最上一行.
+     * width、height 须为 8 的倍数; src_stride 为源每行字节数.
+     */
+    static void PackPages(uint8_t* dst,
+                          const uint8_t* src,
+                          int width,
+                          int height,
+                          size_t src_stride);
+
+    /**
+     * @brief 16/24 位像素的旋转/镜像 (8 种方向, 90/180/270 度旋转为其中的组合)
+     *
+     * src 为 width x height 行优先, dst 为变换后的行优先矩形
+     * (swap_xy 时为 height x width). 源像素 (i, j) 先按 swap_xy 交换为 (u, v),
+     * 再在目标矩形内按 mirror_x / mirror_y 翻转. 按 kTile x kTile 分块遍历,
+     * 使转置时读写都落在少量缓存行内. src 与 dst 不得重叠.
+     */
+    static constexpr int kTile = 16;
+    static void Transform16(uint16_t* dst,
+                            const uint16_t* src,
+                            int width,
+                            int height,
+                            bool swap_xy,
+                            bool mirror_x,
+                            bool mirror_y);
+    static void Transform24(uint8_t* dst,
+                            const uint8_t* src,
+                            int width,
+                            int height,
+                            bool swap_xy,
+                            bool mirror_x,
+                            bool mirror_y);
+
+    static inline uint16_t Pack565(uint8_t r, uint8_t g, uint8_t b)
+    {
+        return (uint16_t)(((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3));
+    }
+};
+
+}  // namespace wrapper
@@ -0,0 +1,97 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace wrapper
+{
+
+/**
+ * @brief 8 位寄存器影子缓存
+ *
+ * 默认所有寄存器都不缓存; 设备驱动按地址区间调用 Cache() 选择性开启,
+ * 状态/中断等会被硬件改写的寄存器用 MarkVolatile() 排除.
+ * 写操作成功后写穿 (write-through) 更新影子值; 读命中时不再访问总线.
+ */
+class RegisterCache
+{
+   public:
+    RegisterCache() { Reset(); }
+
+    // 清空所有配置与影子值
+    void Reset()
+    {
+        memset(values_, 0, sizeof(values_));
+        memset(cacheable_, 0, sizeof(cacheable_));
+        memset(valid_, 0, sizeof(valid_));
+    }
+
+    void Cache(uint8_t first, uint8_t last)
+    {
+        for (int reg = first; reg <= last; reg++)
+        {
+            Set(cacheable_, (uint8_t)reg);
+        }
+    }
+
+    void MarkVolatile(uint8_t first, uint8_t last)
+    {
+        for (int reg = first; reg <= last; reg++)
+        {
+            Clear(cacheable_, (uint8_t)reg);
+            Clear(valid_, (uint8_t)reg);
+        }
+    }
+
+    void Invalidate() { memset(valid_, 0, sizeof(valid_)); }
+
+    void Invalidate(uint8_t first, uint8_t last)
+    {
+        for (int reg = first; reg <= last; reg++)
+        {
+            Clear(valid_, (uint8_t)reg);
+        }
+    }
+
+    bool IsCacheable(uint8_t reg) const { return Test(cacheable_, reg); }
+
+    bool Enabled() const
+    {
+        for (uint32_t word : cacheable_)
+        {
+            if (word != 0)
+                return true;
+        }
+        return false;
+    }
+
+    bool Lookup(uint8_t reg, uint8_t& value) const
+    {
+        if (!Test(valid_, reg))
+            return false;
+        value = values_[reg];
+        return true;
+    }
+
+    void Update(uint8_t reg, uint8_t value)
+    {
+        if (!Test(cacheable_, reg))
+            return;
+        values_[reg] = value;
+        Set(valid_, reg);
+    }
+
+   private:
+    uint8_t values_[256];
+    uint32_t cacheable_[8];
+    uint32_t valid_[8];
+
+    static bool Test(const uint32_t* bits, uint8_t reg)
+    {
+        return (bits[reg >> 5] >> (reg & 31)) & 1u;
+    }
+    static void Set(uint32_t* bits, uint8_t reg) { bits[reg >> 5] |= 1u << (reg & 31); }
+    static void Clear(uint32_t* bits, uint8_t reg) { bits[reg >> 5] &= ~(1u << (reg & 31)); }
+};
+
+}  // namespace wrapper
@@ -5,10 +5,64 @@
 namespace wrapper
 {
 
-SdSpi::SdSpi(Logger& logger) : logger_(logger), card_(nullptr), mounted_(false) {}
+SdSpi::SdSpi(Logger& logger)
+    : logger_(logger),
+      card_(nullptr),
+      mounted_(false),
+      arbiter_(nullptr),
+      arbiter_client_(-1),
+      slot_(-1)
+{
+}
 
 SdSpi::~SdSpi() { Deinit(); }
 
+// ---------------------------------------------------------------------------
+// 总线仲裁
+// ---------------------------------------------------------------------------
+
+namespace
+{
+// do_transaction 回调只带 slot, 通过此表找回所属实例; 仅在 Init/Deinit 中修改
+constexpr size_t kMaxArbitrated = 2;
+SdSpi* g_arbitrated[kMaxArbitrated] = {};
+}  // namespace
+
+esp_err_t SdSpi::DoTransaction(int slot, sdmmc_command_t* cmdinfo)
+{
+    SdSpi* self = nullptr;
+    for (SdSpi* sd : g_arbitrated)
+    {
+        if (sd != nullptr && sd->slot_ == slot)
+            self = sd;
+    }
+    // 挂载过程中句柄尚未回填
+    for (size_t i = 0; self == nullptr && i < kMaxArbitrated; i++)
+    {
+        if (g_arbitrated[i] != nullptr && g_arbitrated[i]->slot_ < 0)
+            self = g_arbitrated[i];
+    }
+    if (self == nullptr)
+    {
+        return sdspi_host_do_transaction(slot, cmdinfo);
+    }
+
+    self->arbiter_->Acquire(self->arbiter_client_, -1);
+    esp_err_t ret = sdspi_host_do_transaction(slot, cmdinfo);
+    self->arbiter_->Release(self->arbiter_client_, cmdinfo->datalen);
+    return ret;
+}
+
+void SdSpi::ReleaseArbitration()
+{
+    for (SdSpi*& entry : g_arbitrated)
+    {
+        if (entry == this)
+            entry = nullptr;
+    }
+    slot_ = -1;
+}
+
 // ---------------------------------------------------------------------------
 // 生命周期
 // ---------------------------------------------------------------------------
@@ -34,16 +88,36 @@ bool SdSpi::Init(const SpiBus& spi_bus,
     // 先存储路径，IDF 挂载时使用 c_str()
     base_path_ = std::string(base_path);
 
+    slot_ = -1;
+    if (arbiter_ != nullptr)
+    {
+        for (SdSpi*& entry : g_arbitrated)
+        {
+            if (entry == nullptr || entry == this)
+            {
+                entry = this;
+                host.do_transaction = &SdSpi::DoTransaction;
+                break;
+            }
+        }
+        if (host.do_transaction != &SdSpi::DoTransaction)
+        {
+            logger_.Warning("Too many arbitrated SD cards, mounting without arbitration");
+        }
+    }
+
     esp_err_t ret = esp_vfs_fat_sdspi_mount(base_path_.c_str(), &host, &cfg, &mount_config, &card_);
     if (ret != ESP_OK)
     {
         logger_.Error("Failed to mount SD (SPI): %s", esp_err_to_name(ret));
+        ReleaseArbitration();
         card_ = nullptr;
         mounted_ = false;
         base_path_.clear();
         return false;
     }
 
+    slot_ = card_->host.slot;
     mounted_ = true;
     logger_.Info("Mounted at %s (CS: %d)", base_path_.c_str(), cfg.gpio_cs);
     return true;
@@ -63,6 +137,7 @@ bool SdSpi::Deinit()
         return false;
     }
 
+    ReleaseArbitration();
     card_ = nullptr;
     mounted_ = false;
     logger_.Info("Unmounted from %s", base_path_.c_str());
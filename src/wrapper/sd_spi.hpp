@@ -73,6 +73,13 @@ class SdSpi
     sdmmc_card_t* card_;
     bool          mounted_;
     std::string   base_path_;
+    SpiArbiter*   arbiter_;
+    int           arbiter_client_;
+    int           slot_;  // sdspi 设备句柄, 挂载完成前为 -1
+
+    // 替换 sdmmc_host_t::do_transaction: 每条 SD 命令 (含数据块) 占用一个仲裁时间片
+    static esp_err_t DoTransaction(int slot, sdmmc_command_t* cmdinfo);
+    void ReleaseArbitration();
 
    public:
     explicit SdSpi(Logger& logger);
@@ -101,6 +108,17 @@ class SdSpi
     /** @brief 卸载 SD 卡，释放 VFS 资源 */
     bool Deinit();
 
+    /**
+     * @brief 接入共享 SPI 总线仲裁（须在 Init() 之前调用）
+     *
+     * 之后每条 SD 命令都先向 arbiter 申请时间片，与分片刷新的显示屏等客户端交错。
+     */
+    void SetArbiter(SpiArbiter& arbiter, int client)
+    {
+        arbiter_        = &arbiter;
+        arbiter_client_ = client;
+    }
+
     // -----------------------------------------------------------------------
     // 状态查询
     // -----------------------------------------------------------------------
@@ -0,0 +1,204 @@
+#include "wrapper/spi-arbiter.hpp"
+#include "esp_timer.h"
+
+using namespace wrapper;
+
+// --- SpiArbiter ---
+
+SpiArbiter::SpiArbiter(Logger& logger)
+    : logger_(logger),
+      clients_{},
+      client_count_(0),
+      owner_(kNone),
+      vtime_floor_(0),
+      aging_us_((int64_t)kDefaultAgingMs * 1000)
+{
+}
+
+int SpiArbiter::AddClient(const char* name, uint8_t priority, uint8_t share)
+{
+    // 客户端表只在初始化阶段增长, 先填好条目再发布计数, 运行中的 Release 不会看到半成品
+    int id = client_count_ < kMaxClients ? (int)client_count_ : kNone;
+    if (id != kNone)
+    {
+        Client& c = clients_[id];
+        c.name = name;
+        c.priority = priority;
+        c.share = share == 0 ? 1 : share;
+        c.waiting = false;
+        c.vtime = vtime_floor_;
+        c.stats = {};
+        c.grant = xSemaphoreCreateBinaryStatic(&c.grant_buffer);
+        taskENTER_CRITICAL(&lock_);
+        client_count_++;
+        taskEXIT_CRITICAL(&lock_);
+    }
+
+    if (id == kNone)
+    {
+        logger_.Error("Client table full (%u)", (unsigned)kMaxClients);
+        return -1;
+    }
+    logger_.Info("Client %d '%s': priority %u, share %u", id, name, priority, share);
+    return id;
+}
+
+void SpiArbiter::SetShare(int client, uint8_t share)
+{
+    if (!Valid(client))
+        return;
+    taskENTER_CRITICAL(&lock_);
+    clients_[client].share = share == 0 ? 1 : share;
+    taskEXIT_CRITICAL(&lock_);
+}
+
+void SpiArbiter::GrantLocked(int client, int64_t now)
+{
+    Client& c = clients_[client];
+    uint32_t wait_us = c.waiting ? (uint32_t)(now - c.wait_start_us) : 0;
+    c.waiting = false;
+    c.stats.grants++;
+    c.stats.total_wait_us += wait_us;
+    if (wait_us > c.stats.max_wait_us)
+        c.stats.max_wait_us = wait_us;
+    owner_ = client;
+    vtime_floor_ = c.vtime;
+}
+
+int SpiArbiter::PickNextLocked(int64_t now)
+{
+    int best = kNone;
+    uint8_t best_priority = 0;
+    for (size_t i = 0; i < client_count_; i++)
+    {
+        const Client& c = clients_[i];
+        if (!c.waiting)
+            continue;
+        // 老化: 等待过久的客户端提升为最高优先级, 再按虚拟时间公平竞争
+        uint8_t priority = now - c.wait_start_us >= aging_us_ ? 0 : c.priority;
+        if (best == kNone || priority < best_priority ||
+            (priority == best_priority && c.vtime < clients_[best].vtime))
+        {
+            best = (int)i;
+            best_priority = priority;
+        }
+    }
+    return best;
+}
+
+bool SpiArbiter::Acquire(int client, int timeout_ms)
+{
+    if (!Valid(client))
+        return false;
+    Client& c = clients_[client];
+    int64_t now = esp_timer_get_time();
+
+    taskENTER_CRITICAL(&lock_);
+    // 空闲期间不积累额度, 否则长时间未访问的客户端回来后会连续独占总线
+    if (c.vtime < vtime_floor_)
+        c.vtime = vtime_floor_;
+    // 有等待者时 owner_ 必然非空 (Release 会直接移交), 因此总线空闲即可立即授权
+    if (owner_ == kNone)
+    {
+        GrantLocked(client, now);
+        taskEXIT_CRITICAL(&lock_);
+        return true;
+    }
+    c.waiting = true;
+    c.wait_start_us = now;
+    taskEXIT_CRITICAL(&lock_);
+
+    TickType_t ticks = timeout_ms < 0 ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms);
+    if (xSemaphoreTake(c.grant, ticks) == pdTRUE)
+        return true;
+
+    // 超时与 Release 的移交可能同时发生, 以 owner_ 为准
+    taskENTER_CRITICAL(&lock_);
+    bool granted = owner_ == client;
+    if (!granted)
+    {
+        c.waiting = false;
+        c.stats.timeouts++;
+    }
+    taskEXIT_CRITICAL(&lock_);
+    if (granted)
+    {
+        // Release 在临界区外才 give, 此时可能尚未发生; 必须等到并取走, 否则授权残留在信号量上
+        xSemaphoreTake(c.grant, portMAX_DELAY);
+    }
+    return granted;
+}
+
+void SpiArbiter::Release(int client, size_t bytes)
+{
+    if (!Valid(client))
+        return;
+    // 每次授权计入固定开销, 避免大量零字节/小事务不推进虚拟时间
+    static constexpr size_t kGrantOverheadBytes = 64;
+    int64_t now = esp_timer_get_time();
+
+    taskENTER_CRITICAL(&lock_);
+    if (owner_ != client)
+    {
+        taskEXIT_CRITICAL(&lock_);
+        logger_.Warning("Client %d released without owning the bus", client);
+        return;
+    }
+    Client& c = clients_[client];
+    c.stats.bytes += bytes;
+    c.vtime += (uint64_t)(bytes + kGrantOverheadBytes) * kVtimeScale / c.share;
+    owner_ = kNone;
+    int next = PickNextLocked(now);
+    if (next != kNone)
+    {
+        GrantLocked(next, now);
+    }
+    taskEXIT_CRITICAL(&lock_);
+
+    if (next != kNone)
+    {
+        xSemaphoreGive(clients_[next].grant);
+    }
+}
+
+// --- SpiArbiter statistics ---
+
+SpiArbiterClientStats SpiArbiter::GetClientStats(int client) const
+{
+    if (!Valid(client))
+        return {};
+    taskENTER_CRITICAL(&lock_);
+    SpiArbiterClientStats stats = clients_[client].stats;
+    taskEXIT_CRITICAL(&lock_);
+    return stats;
+}
+
+const char* SpiArbiter::GetClientName(int client) const
+{
+    return Valid(client) ? clients_[client].name : "";
+}
+
+void SpiArbiter::ResetStats()
+{
+    taskENTER_CRITICAL(&lock_);
+    for (size_t i = 0; i < client_count_; i++)
+    {
+        clients_[i].stats = {};
+    }
+    taskEXIT_CRITICAL(&lock_);
+}
+
+void SpiArbiter::Print(FILE* out) const
+{
+    fprintf(out, "%-12s %4s %5s %8s %8s %10s %10s %12s\n", "client", "prio", "share", "grants",
+            "timeouts", "avg_wait", "max_wait", "bytes");
+    for (size_t i = 0; i < client_count_; i++)
+    {
+        SpiArbiterClientStats s = GetClientStats((int)i);
+        const Client& c = clients_[i];
+        unsigned long avg = s.grants ? (unsigned long)(s.total_wait_us / s.grants) : 0;
+        fprintf(out, "%-12s %4u %5u %8lu %8lu %8lu us %8lu us %12llu\n", c.name, c.priority,
+                c.share, (unsigned long)s.grants, (unsigned long)s.timeouts, avg,
+                (unsigned long)s.max_wait_us, (unsigned long long)s.bytes);
+    }
+}
@@ -0,0 +1,96 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "wrapper/logger.hpp"
+
+namespace wrapper
+{
+
+struct SpiArbiterClientStats
+{
+    uint32_t grants = 0;
+    uint32_t timeouts = 0;
+    uint32_t max_wait_us = 0;
+    uint64_t total_wait_us = 0;
+    uint64_t bytes = 0;
+};
+
+/**
+ * @brief 共享 SPI 总线的分片仲裁
+ *
+ * spi_master 只在单个事务之间切换设备, 一次整屏刷新 (数十个 DMA 事务连续排队) 会把
+ * SD 卡、射频等设备挡在后面几十毫秒. 仲裁器在驱动之上按 "片" 分配总线:
+ * 客户端每次 Acquire() 获得一个时间片, 完成一段有界传输后 Release() 并报告字节数.
+ *
+ * 调度规则:
+ *   - priority 数值小者优先; 等待超过 aging_ms 的客户端视为最高优先级, 避免饿死.
+ *   - 同优先级按 share 加权公平排队: 每个客户端累计 bytes / share 的虚拟时间,
+ *     虚拟时间最小者先获得总线. 例如 display share=3、sd share=1 时,
+ *     两者持续竞争下 SD 约获得 1/4 的带宽.
+ *
+ * 仲裁是协作式的, 只约束通过仲裁器访问总线的客户端 (SpiDisplay 分片刷新、
+ * SpiDevice::SetArbiter、SdSpi::SetArbiter). 获取顺序固定为先仲裁器、后 spi_device_acquire_bus.
+ */
+class SpiArbiter
+{
+   public:
+    static constexpr size_t kMaxClients = 8;
+    static constexpr uint32_t kDefaultAgingMs = 20;
+
+    SpiArbiter(Logger& logger);
+    ~SpiArbiter() = default;
+
+    SpiArbiter(const SpiArbiter&) = delete;
+    SpiArbiter& operator=(const SpiArbiter&) = delete;
+
+    // 返回客户端 ID, 失败返回 -1; 应在初始化阶段调用.
+    // priority: 0 最高; share: 同优先级间的带宽权重 (>= 1)
+    int AddClient(const char* name, uint8_t priority, uint8_t share);
+    void SetShare(int client, uint8_t share);
+    void SetAging(uint32_t aging_ms) { aging_us_ = (int64_t)aging_ms * 1000; }
+
+    // 不可重入: 同一客户端在 Release 前不能再次 Acquire
+    bool Acquire(int client, int timeout_ms);
+    void Release(int client, size_t bytes);
+
+    SpiArbiterClientStats GetClientStats(int client) const;
+    const char* GetClientName(int client) const;
+    size_t GetClientCount() const { return client_count_; }
+    void ResetStats();
+    void Print(FILE* out) const;
+
+   private:
+    static constexpr int kNone = -1;
+    static constexpr uint64_t kVtimeScale = 256;
+
+    struct Client
+    {
+        const char* name;
+        uint8_t priority;
+        uint8_t share;
+        bool waiting;
+        int64_t wait_start_us;
+        uint64_t vtime;
+        SpiArbiterClientStats stats;
+        StaticSemaphore_t grant_buffer;
+        SemaphoreHandle_t grant;
+    };
+
+    Logger& logger_;
+    Client clients_[kMaxClients];
+    size_t client_count_;
+    int owner_;
+    uint64_t vtime_floor_;  // 最近一次授权时的虚拟时间, 空闲客户端回到队列时不得低于此值
+    int64_t aging_us_;
+    mutable portMUX_TYPE lock_ = portMUX_INITIALIZER_UNLOCKED;
+
+    bool Valid(int client) const { return client >= 0 && client < (int)client_count_; }
+    // 锁内调用: 选出下一个持有者并记录等待时间, 无等待者返回 kNone
+    int PickNextLocked(int64_t now);
+    void GrantLocked(int client, int64_t now);
+};
+
+}  // namespace wrapper
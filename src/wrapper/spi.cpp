@@ -1,4 +1,7 @@
 #include "wrapper/spi.hpp"
+#include "esp_attr.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
 #include <cstring>
 
 // --- SpiBus ---
@@ -50,6 +53,7 @@ bool SpiBus::Init(const SpiBusConfig& config)
     {
         host_id_ = config.host_id;
         initialized_ = true;
+        stats_.Attach("spi%d", (int)host_id_ + 1);
         logger_.Info("Initialized (Host: %d, MOSI: %d, MISO: %d, SCLK: %d)", config.host_id,
                      config.mosi_io_num, config.miso_io_num, config.sclk_io_num);
         return true;
@@ -70,6 +74,7 @@ bool SpiBus::Deinit()
         {
             logger_.Info("Deinitialized");
             initialized_ = false;
+            stats_.Detach();
             return true;
         }
         else
@@ -103,7 +108,25 @@ bool SpiBus::Reset()
 
 // --- SpiDevice ---
 
-SpiDevice::SpiDevice(Logger& logger) : logger_(logger), dev_handle_(NULL) {}
+SpiDevice::SpiDevice(Logger& logger)
+    : logger_(logger),
+      dev_handle_(NULL),
+      bus_(nullptr),
+      trace_id_(0),
+      reg_format_{},
+      polling_max_bytes_(4),
+      arbiter_(nullptr),
+      arbiter_client_(-1),
+      bus_held_(false),
+      held_bytes_(0),
+      slots_{},
+      slot_count_(0),
+      chunk_size_(0),
+      in_flight_(0),
+      queue_size_(0),
+      queue_notify_(nullptr)
+{
+}
 
 SpiDevice::~SpiDevice() { Deinit(); }
 
@@ -121,9 +144,19 @@ bool SpiDevice::Init(const SpiBus& bus, const SpiDeviceConfig& config)
     // We check this implicitly by bus.GetHostId(), but really the user should ensure bus is Init'd.
     // Unlike I2C new driver, SPI driver relies on Host ID.
 
-    esp_err_t ret = spi_bus_add_device(bus.GetHostId(), &config, &dev_handle_);
+    // 未指定 post_cb 时挂接队列完成通知; 阻塞式传输的 user 为空, 回调直接忽略
+    spi_device_interface_config_t dev_config = config;
+    if (dev_config.post_cb == NULL)
+    {
+        dev_config.post_cb = OnPostTrans;
+    }
+    esp_err_t ret = spi_bus_add_device(bus.GetHostId(), &dev_config, &dev_handle_);
     if (ret == ESP_OK)
     {
+        bus_ = &bus;
+        queue_size_ = config.queue_size;
+        trace_id_ = BusTrace::SpiId(bus.GetHostId(), config.spics_io_num);
+        stats_.Attach("spi%d.cs%d", (int)bus.GetHostId() + 1, config.spics_io_num);
         logger_.Info("Device initialized (CS: %d, Speed: %d Hz)", config.spics_io_num,
                      config.clock_speed_hz);
         return true;
@@ -139,11 +172,15 @@ bool SpiDevice::Deinit()
 {
     if (dev_handle_ != NULL)
     {
+        DeinitQueue();
         esp_err_t ret = spi_bus_remove_device(dev_handle_);
         if (ret == ESP_OK)
         {
             logger_.Info("Device deinitialized");
             dev_handle_ = NULL;
+            bus_ = nullptr;
+            reg_cache_.Invalidate();
+            stats_.Detach();
             return true;
         }
         else
@@ -155,6 +192,173 @@ bool SpiDevice::Deinit()
     return true;
 }
 
+bool SpiDevice::AcquireBus(int timeout_ms)
+{
+    if (dev_handle_ == NULL)
+        return false;
+    if (in_flight_ > 0)
+    {
+        FlushQueue(-1);
+    }
+    // 先仲裁器后驱动锁, 与 SpiDisplay / SdSpi 的获取顺序一致
+    if (arbiter_ != nullptr && !arbiter_->Acquire(arbiter_client_, timeout_ms))
+    {
+        logger_.Error("Failed to acquire bus: arbiter timeout");
+        return false;
+    }
+    // 驱动只接受 portMAX_DELAY, timeout_ms 只作用于仲裁器等待
+    esp_err_t ret = spi_device_acquire_bus(dev_handle_, portMAX_DELAY);
+    if (ret != ESP_OK)
+    {
+        if (arbiter_ != nullptr)
+            arbiter_->Release(arbiter_client_, 0);
+        logger_.Error("Failed to acquire bus: %s", esp_err_to_name(ret));
+        return false;
+    }
+    bus_held_ = true;
+    held_bytes_ = 0;
+    return true;
+}
+
+void SpiDevice::ReleaseBus()
+{
+    if (dev_handle_ != NULL && bus_held_)
+    {
+        spi_device_release_bus(dev_handle_);
+        bus_held_ = false;
+        if (arbiter_ != nullptr)
+            arbiter_->Release(arbiter_client_, held_bytes_);
+    }
+}
+
+bool SpiDevice::Transmit(spi_transaction_t* t)
+{
+    // 驱动要求取回所有队列结果后才能同步传输
+    if (in_flight_ > 0)
+    {
+        FlushQueue(-1);
+    }
+
+    size_t bytes = (t->rxlength > t->length ? t->rxlength : t->length) / 8;
+    bool polling = bytes <= polling_max_bytes_;
+    // 已在 AcquireBus 区间内时时间片由该区间统一占用
+    bool arbitrate = arbiter_ != nullptr && !bus_held_;
+    if (arbitrate && !arbiter_->Acquire(arbiter_client_, -1))
+    {
+        return false;
+    }
+    if (bus_held_)
+    {
+        held_bytes_ += bytes;
+    }
+
+    int64_t start = 0;
+    if constexpr (BusStats::kEnabled || BusTrace::kEnabled)
+    {
+        start = esp_timer_get_time();
+    }
+    esp_err_t ret = polling ? spi_device_polling_transmit(dev_handle_, t)
+                            : spi_device_transmit(dev_handle_, t);
+    if (arbitrate)
+    {
+        arbiter_->Release(arbiter_client_, bytes);
+    }
+    if constexpr (!BusStats::kEnabled && !BusTrace::kEnabled)
+    {
+        return ret == ESP_OK;
+    }
+
+    uint32_t elapsed_us = (uint32_t)(esp_timer_get_time() - start);
+    if constexpr (BusStats::kEnabled)
+    {
+        stats_.Record(bytes, ret, elapsed_us);
+        if (bus_ != nullptr)
+        {
+            bus_->GetStats().Record(bytes, ret, elapsed_us);
+        }
+    }
+    if constexpr (BusTrace::kEnabled)
+    {
+        // 寄存器取地址相位, 否则取首个发送字节
+        uint8_t reg = 0;
+        if (t->flags & SPI_TRANS_VARIABLE_ADDR)
+            reg = (uint8_t)t->addr;
+        else if (t->flags & SPI_TRANS_USE_TXDATA)
+            reg = t->tx_data[0];
+        else if (t->tx_buffer != nullptr && t->length >= 8)
+            reg = *static_cast<const uint8_t*>(t->tx_buffer);
+        BusTrace::Record(trace_id_, BusTraceKind::SpiTransfer, reg, bytes, ret, start,
+                         elapsed_us);
+    }
+    return ret == ESP_OK;
+}
+
+bool SpiDevice::Execute(SpiSequence& sequence, int timeout_ms)
+{
+    if (dev_handle_ == NULL)
+    {
+        logger_.Error("Cannot execute sequence: Not initialized");
+        return false;
+    }
+    if (sequence.Overflow())
+    {
+        logger_.Error("Sequence overflow (max %u segments)", (unsigned)SpiSequence::kMaxSegments);
+        return false;
+    }
+    if (sequence.Empty())
+        return true;
+
+    // CS_KEEP_ACTIVE 要求事务期间持有总线
+    bool acquired = false;
+    if (!bus_held_)
+    {
+        if (!AcquireBus(timeout_ms))
+            return false;
+        acquired = true;
+    }
+
+    bool ok = true;
+    size_t last = sequence.count_ - 1;
+    for (size_t i = 0; i <= last && ok; i++)
+    {
+        const SpiSequence::Segment& seg = sequence.segs_[i];
+        spi_transaction_t t = {};
+        t.length = seg.len * 8;
+        t.rxlength = seg.rx != nullptr ? seg.len * 8 : 0;
+        t.flags = i < last ? SPI_TRANS_CS_KEEP_ACTIVE : 0;
+        if (seg.len <= 4)
+        {
+            t.flags |= SPI_TRANS_USE_TXDATA | (seg.rx != nullptr ? SPI_TRANS_USE_RXDATA : 0);
+            if (seg.tx != nullptr)
+                memcpy(t.tx_data, seg.tx, seg.len);
+        }
+        else
+        {
+            t.tx_buffer = seg.tx;
+            t.rx_buffer = seg.rx;
+        }
+
+        ok = Transmit(&t);
+        if (ok && seg.rx != nullptr && (t.flags & SPI_TRANS_USE_RXDATA))
+        {
+            memcpy(seg.rx, t.rx_data, seg.len);
+        }
+    }
+
+    if (!ok)
+    {
+        // 中途失败时上一段仍保持着片选, 发送一个不带 KEEP_ACTIVE 的空事务结束本次 CS 周期
+        spi_transaction_t end = {};
+        spi_device_polling_transmit(dev_handle_, &end);
+        logger_.Error("Sequence aborted");
+    }
+    if (acquired)
+    {
+        ReleaseBus();
+    }
+    return ok;
+}
+
 bool SpiDevice::Transfer(const std::vector<uint8_t>& tx_data, std::vector<uint8_t>& rx_data)
 {
     if (dev_handle_ == NULL)
@@ -171,7 +375,7 @@ bool SpiDevice::Transfer(const std::vector<uint8_t>& tx_data, std::vector<uint8_
     rx_data.resize(tx_data.size());
     t.rx_buffer = rx_data.data();
 
-    return spi_device_transmit(dev_handle_, &t) == ESP_OK;
+    return Transmit(&t);
 }
 
 bool SpiDevice::Write(const std::vector<uint8_t>& data)
@@ -188,7 +392,7 @@ bool SpiDevice::Write(const std::vector<uint8_t>& data)
     t.tx_buffer = data.data();
     t.rx_buffer = NULL;  // No receive
 
-    return spi_device_transmit(dev_handle_, &t) == ESP_OK;
+    return Transmit(&t);
 }
 
 bool SpiDevice::Read(size_t len, std::vector<uint8_t>& rx_data)
@@ -207,7 +411,7 @@ bool SpiDevice::Read(size_t len, std::vector<uint8_t>& rx_data)
     rx_data.resize(len);
     t.rx_buffer = rx_data.data();
 
-    return spi_device_transmit(dev_handle_, &t) == ESP_OK;
+    return Transmit(&t);
 }
 
 bool SpiDevice::WriteByte(uint8_t data)
@@ -216,7 +420,7 @@ bool SpiDevice::WriteByte(uint8_t data)
     t.length = 8;
     t.tx_buffer = &data;
     t.rx_buffer = nullptr;
-    return spi_device_transmit(dev_handle_, &t) == ESP_OK;
+    return Transmit(&t);
 }
 
 bool SpiDevice::ReadByte(uint8_t& data)
@@ -225,66 +429,121 @@ bool SpiDevice::ReadByte(uint8_t& data)
     t.length = 8;
     t.tx_buffer = nullptr;
     t.rx_buffer = &data;
-    return spi_device_transmit(dev_handle_, &t) == ESP_OK;
+    return Transmit(&t);
 }
 
-bool SpiDevice::WriteRegBytes(uint8_t reg_addr, const std::vector<uint8_t>& data)
+bool SpiDevice::RegTransfer(uint8_t reg_addr, const uint8_t* tx_data, uint8_t* rx_data, size_t len)
 {
-    std::vector<uint8_t> tx;
-    tx.reserve(1 + data.size());
-    tx.push_back(reg_addr);
-    tx.insert(tx.end(), data.begin(), data.end());
+    if (dev_handle_ == NULL)
+    {
+        return false;
+    }
 
-    spi_transaction_t t = {};
-    t.length = tx.size() * 8;
-    t.tx_buffer = tx.data();
-    t.rx_buffer = nullptr;
-    return spi_device_transmit(dev_handle_, &t) == ESP_OK;
+    bool read = rx_data != nullptr;
+    spi_transaction_ext_t t = {};
+    t.base.flags = SPI_TRANS_VARIABLE_ADDR;
+    t.base.addr = reg_addr | (read ? reg_format_.read_mask : reg_format_.write_mask);
+    t.address_bits = reg_format_.address_bits;
+    t.base.length = len * 8;
+    if (reg_format_.command_bits > 0)
+    {
+        t.base.flags |= SPI_TRANS_VARIABLE_CMD;
+        t.base.cmd = read ? reg_format_.read_command : reg_format_.write_command;
+        t.command_bits = reg_format_.command_bits;
+    }
+
+    if (tx_data != nullptr && len <= sizeof(t.base.tx_data))
+    {
+        t.base.flags |= SPI_TRANS_USE_TXDATA;
+        memcpy(t.base.tx_data, tx_data, len);
+    }
+    else
+    {
+        t.base.tx_buffer = tx_data;
+    }
+
+    bool inline_rx = rx_data != nullptr && len <= sizeof(t.base.rx_data);
+    if (inline_rx)
+    {
+        t.base.flags |= SPI_TRANS_USE_RXDATA;
+    }
+    else
+    {
+        t.base.rx_buffer = rx_data;
+    }
+
+    if (!Transmit(&t.base))
+    {
+        return false;
+    }
+    if (inline_rx)
+    {
+        memcpy(rx_data, t.base.rx_data, len);
+    }
+    return true;
+}
+
+bool SpiDevice::WriteRegBytes(uint8_t reg_addr, const std::vector<uint8_t>& data)
+{
+    return WriteRegBytes(reg_addr, std::span<const uint8_t>(data));
 }
 
 bool SpiDevice::ReadRegBytes(uint8_t reg_addr, std::vector<uint8_t>& data, size_t len)
 {
-    std::vector<uint8_t> tx(1 + len, 0x00);
-    tx[0] = reg_addr;
-    std::vector<uint8_t> rx(1 + len, 0x00);
+    data.resize(len);
+    return ReadRegBytes(reg_addr, std::span<uint8_t>(data));
+}
 
-    spi_transaction_t t = {};
-    t.length = (1 + len) * 8;
-    t.tx_buffer = tx.data();
-    t.rx_buffer = rx.data();
+bool SpiDevice::WriteRegBytes(uint8_t reg_addr, std::span<const uint8_t> data)
+{
+    if (!RegTransfer(reg_addr, data.data(), nullptr, data.size()))
+        return false;
 
-    if (spi_device_transmit(dev_handle_, &t) != ESP_OK)
+    if (data.size() == 1)
     {
-        return false;
+        reg_cache_.Update(reg_addr, data[0]);
+    }
+    else if (data.size() > 1)
+    {
+        size_t last = reg_addr + data.size() - 1;
+        reg_cache_.Invalidate(reg_addr, last > 0xFF ? 0xFF : (uint8_t)last);
     }
-    data.assign(rx.begin() + 1, rx.end());
     return true;
 }
 
+bool SpiDevice::ReadRegBytes(uint8_t reg_addr, std::span<uint8_t> data)
+{
+    return RegTransfer(reg_addr, nullptr, data.data(), data.size());
+}
+
 bool SpiDevice::WriteReg8(uint8_t reg_addr, uint8_t data)
 {
-    return WriteRegBytes(reg_addr, {data});
+    const uint8_t buf[1] = {data};
+    return WriteRegBytes(reg_addr, buf);
 }
 
 bool SpiDevice::ReadReg8(uint8_t reg_addr, uint8_t& data)
 {
-    std::vector<uint8_t> buf;
-    if (!ReadRegBytes(reg_addr, buf, 1))
+    if (reg_cache_.Lookup(reg_addr, data))
+        return true;
+    uint8_t buf[1];
+    if (!ReadRegBytes(reg_addr, buf))
         return false;
     data = buf[0];
+    reg_cache_.Update(reg_addr, data);
     return true;
 }
 
 bool SpiDevice::WriteReg16(uint8_t reg_addr, uint16_t data)
 {
-    return WriteRegBytes(reg_addr,
-                         {static_cast<uint8_t>(data >> 8), static_cast<uint8_t>(data & 0xFF)});
+    const uint8_t buf[2] = {static_cast<uint8_t>(data >> 8), static_cast<uint8_t>(data & 0xFF)};
+    return WriteRegBytes(reg_addr, buf);
 }
 
 bool SpiDevice::ReadReg16(uint8_t reg_addr, uint16_t& data)
 {
-    std::vector<uint8_t> buf;
-    if (!ReadRegBytes(reg_addr, buf, 2))
+    uint8_t buf[2];
+    if (!ReadRegBytes(reg_addr, buf))
         return false;
     data = (static_cast<uint16_t>(buf[0]) << 8) | buf[1];
     return true;
@@ -292,15 +551,15 @@ bool SpiDevice::ReadReg16(uint8_t reg_addr, uint16_t& data)
 
 bool SpiDevice::WriteReg32(uint8_t reg_addr, uint32_t data)
 {
-    return WriteRegBytes(reg_addr,
-                         {static_cast<uint8_t>(data >> 24), static_cast<uint8_t>(data >> 16),
-                          static_cast<uint8_t>(data >> 8), static_cast<uint8_t>(data & 0xFF)});
+    const uint8_t buf[4] = {static_cast<uint8_t>(data >> 24), static_cast<uint8_t>(data >> 16),
+                            static_cast<uint8_t>(data >> 8), static_cast<uint8_t>(data & 0xFF)};
+    return WriteRegBytes(reg_addr, buf);
 }
 
 bool SpiDevice::ReadReg32(uint8_t reg_addr, uint32_t& data)
 {
-    std::vector<uint8_t> buf;
-    if (!ReadRegBytes(reg_addr, buf, 4))
+    uint8_t buf[4];
+    if (!ReadRegBytes(reg_addr, buf))
         return false;
     data = (static_cast<uint32_t>(buf[0]) << 24) | (static_cast<uint32_t>(buf[1]) << 16) |
            (static_cast<uint32_t>(buf[2]) << 8) | static_cast<uint32_t>(buf[3]);
@@ -345,3 +604,247 @@ bool SpiDevice::ReadRegBits(uint8_t reg_addr, uint8_t mask, uint8_t& value)
     value = reg & mask;
     return true;
 }
+
+void SpiDevice::CacheRegisters(uint8_t first_reg, uint8_t last_reg)
+{
+    reg_cache_.Cache(first_reg, last_reg);
+}
+
+void SpiDevice::MarkVolatile(uint8_t first_reg, uint8_t last_reg)
+{
+    reg_cache_.MarkVolatile(first_reg, last_reg);
+}
+
+void SpiDevice::InvalidateCache() { reg_cache_.Invalidate(); }
+
+void SpiDevice::InvalidateCache(uint8_t first_reg, uint8_t last_reg)
+{
+    reg_cache_.Invalidate(first_reg, last_reg);
+}
+
+bool SpiDevice::RefreshCache()
+{
+    reg_cache_.Invalidate();
+    for (int reg = 0; reg < 256; reg++)
+    {
+        uint8_t value = 0;
+        if (reg_cache_.IsCacheable((uint8_t)reg) && !ReadReg8((uint8_t)reg, value))
+            return false;
+    }
+    return true;
+}
+
+// --- SpiDevice queued transfers ---
+
+static TickType_t ToTicks(int timeout_ms)
+{
+    return timeout_ms < 0 ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms);
+}
+
+bool SpiDevice::InitQueue(size_t depth, size_t chunk_size)
+{
+    if (dev_handle_ == NULL)
+    {
+        logger_.Error("Init queue: device not initialized");
+        return false;
+    }
+    if (depth == 0 || depth > kMaxQueueSlots || (int)depth > queue_size_ || chunk_size == 0)
+    {
+        logger_.Error("Init queue: invalid depth %u (max %u, queue_size %d) or chunk size",
+                      (unsigned)depth, (unsigned)kMaxQueueSlots, queue_size_);
+        return false;
+    }
+    DeinitQueue();
+
+    for (size_t i = 0; i < depth; i++)
+    {
+        uint8_t* buffer = static_cast<uint8_t*>(heap_caps_malloc(chunk_size, MALLOC_CAP_DMA));
+        if (buffer == nullptr)
+        {
+            logger_.Error("Init queue: failed to allocate %u byte DMA buffer", (unsigned)chunk_size);
+            DeinitQueue();
+            return false;
+        }
+        slots_[i] = {};
+        slots_[i].owner = this;
+        slots_[i].buffer = buffer;
+        slots_[i].free = true;
+        slot_count_ = i + 1;
+    }
+    chunk_size_ = chunk_size;
+    logger_.Info("Queue initialized (%u x %u bytes)", (unsigned)depth, (unsigned)chunk_size);
+    return true;
+}
+
+void SpiDevice::DeinitQueue()
+{
+    if (slot_count_ == 0)
+        return;
+    FlushQueue(-1);
+    for (size_t i = 0; i < slot_count_; i++)
+    {
+        heap_caps_free(slots_[i].buffer);
+        slots_[i] = {};
+    }
+    slot_count_ = 0;
+    chunk_size_ = 0;
+}
+
+int SpiDevice::AcquireSlot(int timeout_ms)
+{
+    while (true)
+    {
+        for (size_t i = 0; i < slot_count_; i++)
+        {
+            if (slots_[i].free)
+            {
+                slots_[i].free = false;
+                return (int)i;
+            }
+        }
+        // 缓冲池用尽: 等待最早提交的一笔完成
+        if (in_flight_ == 0 || !ReclaimOne(timeout_ms))
+            return -1;
+    }
+}
+
+bool SpiDevice::SubmitSlot(int slot, const uint8_t* tx, uint8_t* rx, size_t len)
+{
+    QueueSlot& s = slots_[slot];
+    s.trans = {};
+    s.trans.length = len * 8;
+    s.trans.tx_buffer = tx;
+    s.trans.rx_buffer = rx;
+    s.trans.user = &s;
+
+    // 槽位数不超过设备 queue_size, 驱动队列不会满
+    esp_err_t ret = spi_device_queue_trans(dev_handle_, &s.trans, 0);
+    if (ret != ESP_OK)
+    {
+        logger_.Error("Queue transfer failed: %s", esp_err_to_name(ret));
+        s.free = true;
+        return false;
+    }
+    in_flight_++;
+    return true;
+}
+
+bool SpiDevice::ReclaimOne(int timeout_ms)
+{
+    spi_transaction_t* done = nullptr;
+    if (spi_device_get_trans_result(dev_handle_, &done, ToTicks(timeout_ms)) != ESP_OK)
+        return false;
+    QueueSlot* s = static_cast<QueueSlot*>(done->user);
+    s->free = true;
+    in_flight_--;
+    if constexpr (BusStats::kEnabled)
+    {
+        // 队列传输只统计次数与字节, 耗时不可得
+        stats_.Record(done->length / 8, ESP_OK, 0);
+        if (bus_ != nullptr)
+        {
+            bus_->GetStats().Record(done->length / 8, ESP_OK, 0);
+        }
+    }
+    return true;
+}
+
+bool SpiDevice::AcquireChunk(SpiChunk& chunk, int timeout_ms)
+{
+    int slot = AcquireSlot(timeout_ms);
+    if (slot < 0)
+        return false;
+    chunk.data = slots_[slot].buffer;
+    chunk.capacity = chunk_size_;
+    chunk.slot = slot;
+    return true;
+}
+
+bool SpiDevice::QueueChunk(SpiChunk& chunk, size_t len, SpiQueueCallback callback, void* arg)
+{
+    if (chunk.slot < 0 || (size_t)chunk.slot >= slot_count_ || len > chunk.capacity)
+        return false;
+    QueueSlot& s = slots_[chunk.slot];
+    s.callback = callback;
+    s.arg = arg;
+    bool ok = SubmitSlot(chunk.slot, s.buffer, nullptr, len);
+    chunk = {};
+    return ok;
+}
+
+bool SpiDevice::QueueTransfer(const uint8_t* tx_data,
+                              uint8_t* rx_data,
+                              size_t len,
+                              int timeout_ms,
+                              SpiQueueCallback callback,
+                              void* arg)
+{
+    int slot = AcquireSlot(timeout_ms);
+    if (slot < 0)
+        return false;
+    slots_[slot].callback = callback;
+    slots_[slot].arg = arg;
+    return SubmitSlot(slot, tx_data, rx_data, len);
+}
+
+bool SpiDevice::QueueWrite(const uint8_t* data, size_t len, int timeout_ms)
+{
+    if (slot_count_ == 0)
+    {
+        logger_.Error("Queue write: queue not initialized");
+        return false;
+    }
+    while (len > 0)
+    {
+        SpiChunk chunk;
+        if (!AcquireChunk(chunk, timeout_ms))
+            return false;
+        size_t n = len < chunk.capacity ? len : chunk.capacity;
+        memcpy(chunk.data, data, n);
+        if (!QueueChunk(chunk, n))
+            return false;
+        data += n;
+        len -= n;
+    }
+    return true;
+}
+
+size_t SpiDevice::ReclaimQueued()
+{
+    size_t count = 0;
+    while (in_flight_ > 0 && ReclaimOne(0))
+    {
+        count++;
+    }
+    return count;
+}
+
+bool SpiDevice::FlushQueue(int timeout_ms)
+{
+    while (in_flight_ > 0)
+    {
+        if (!ReclaimOne(timeout_ms))
+            return false;
+    }
+    return true;
+}
+
+void IRAM_ATTR SpiDevice::OnPostTrans(spi_transaction_t* t)
+{
+    QueueSlot* s = static_cast<QueueSlot*>(t->user);
+    if (s == nullptr)
+        return;
+    if (s->callback != nullptr)
+    {
+        s->callback(s->arg);
+    }
+    if (s->owner->queue_notify_ != nullptr)
+    {
+        BaseType_t woken = pdFALSE;
+        vTaskNotifyGiveFromISR(s->owner->queue_notify_, &woken);
+        if (woken == pdTRUE)
+        {
+            portYIELD_FROM_ISR();
+        }
+    }
+}
@@ -2,11 +2,18 @@
 
 #include "driver/spi_master.h"
 #include "driver/gpio.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
 #include "esp_lcd_panel_io.h"
 #include "esp_lcd_panel_ops.h"
 #include "esp_lcd_panel_dev.h"
 #include "esp_lcd_panel_ssd1306.h"
 #include "wrapper/logger.hpp"
+#include "wrapper/bus-stats.hpp"
+#include "wrapper/bus-trace.hpp"
+#include "wrapper/spi-arbiter.hpp"
+#include "wrapper/register-cache.hpp"
+#include <span>
 #include <vector>
 #include <functional>
 
@@ -62,6 +69,7 @@ class SpiBus
     spi_host_device_t host_id_;
     bool initialized_;
     SpiBusConfig config_;
+    mutable BusStats stats_;
 
    public:
     SpiBus(Logger& logger);
@@ -72,11 +80,14 @@ class SpiBus
     bool Init(const SpiBusConfig& config);
     bool Deinit();
     bool Reset();
+
+    // 总线汇总统计 (CONFIG_WRAPPER_ESP32_BUS_STATS)
+    BusStats& GetStats() const { return stats_; }
 };
 
 struct SpiDeviceConfig : public spi_device_interface_config_t
 {
-    SpiDeviceConfig(gpio_num_t cs, int clock_speed_hz, uint8_t mode)
+    SpiDeviceConfig(gpio_num_t cs, int clock_speed_hz, uint8_t mode, int queue_depth = 3)
         : spi_device_interface_config_t{}
     {
         command_bits = 0;
@@ -90,17 +101,145 @@ struct SpiDeviceConfig : public spi_device_interface_config_t
         input_delay_ns = 0;
         spics_io_num = cs;
         flags = 0;
-        queue_size = 3;
+        queue_size = queue_depth;
         pre_cb = NULL;
         post_cb = NULL;
     }
 };
 
+// 寄存器访问的命令/地址相位格式, 寄存器字节不再拼入数据缓冲
+struct SpiRegFormat
+{
+    uint8_t command_bits = 0;  // 0: 无命令相位
+    uint16_t read_command = 0;
+    uint16_t write_command = 0;
+    uint8_t address_bits = 8;
+    uint8_t read_mask = 0;  // 读时与地址相或, 例如 0x80
+    uint8_t write_mask = 0;
+};
+
+// 队列传输完成回调, 在 SPI 中断中执行: 须位于 IRAM 且不可阻塞
+using SpiQueueCallback = void (*)(void* arg);
+
+// 从预分配 DMA 缓冲池借出的一块缓冲区, 填充后交给 QueueChunk 提交
+struct SpiChunk
+{
+    uint8_t* data = nullptr;
+    size_t capacity = 0;
+    int slot = -1;
+};
+
+/**
+ * @brief 片选保持的多段传输序列
+ *
+ * 各段在同一次 CS 有效期内背靠背执行 (SPI_TRANS_CS_KEEP_ACTIVE), 可混合只发送、只接收和全双工段,
+ * 例如 "命令 -> 长数据 -> 状态读取". 缓冲区由调用方持有, 须在 SpiDevice::Execute 返回前保持有效;
+ * 不超过 4 字节的段使用事务内联缓冲.
+ *
+ *     SpiSequence seq;
+ *     seq.Write(cmd, 2);
+ *     seq.Write(fifo, 255);
+ *     seq.Read(&status, 1);
+ *     dev.Execute(seq);
+ */
+class SpiSequence
+{
+   public:
+    static constexpr size_t kMaxSegments = 8;
+
+    SpiSequence() { Clear(); }
+    SpiSequence(const SpiSequence&) = delete;
+    SpiSequence& operator=(const SpiSequence&) = delete;
+
+    void Clear()
+    {
+        count_ = 0;
+        overflow_ = false;
+    }
+    size_t Size() const { return count_; }
+    bool Empty() const { return count_ == 0; }
+    bool Overflow() const { return overflow_; }
+
+    bool Write(const uint8_t* data, size_t len) { return Add(data, nullptr, len); }
+    bool Read(uint8_t* data, size_t len) { return Add(nullptr, data, len); }
+    bool Transfer(const uint8_t* tx_data, uint8_t* rx_data, size_t len)
+    {
+        return Add(tx_data, rx_data, len);
+    }
+
+   private:
+    friend class SpiDevice;
+
+    struct Segment
+    {
+        const uint8_t* tx;
+        uint8_t* rx;
+        size_t len;
+    };
+
+    Segment segs_[kMaxSegments];
+    size_t count_;
+    bool overflow_;
+
+    bool Add(const uint8_t* tx, uint8_t* rx, size_t len)
+    {
+        if (count_ == kMaxSegments || len == 0)
+        {
+            overflow_ = overflow_ || count_ == kMaxSegments;
+            return false;
+        }
+        segs_[count_++] = {tx, rx, len};
+        return true;
+    }
+};
+
 class SpiDevice
 {
+   public:
+    static constexpr size_t kMaxQueueSlots = 8;
+
    protected:
     Logger& logger_;
     spi_device_handle_t dev_handle_;
+    const SpiBus* bus_;
+    RegisterCache reg_cache_;
+    BusStats stats_;
+    uint16_t trace_id_;
+    SpiRegFormat reg_format_;
+    size_t polling_max_bytes_;
+    SpiArbiter* arbiter_;
+    int arbiter_client_;
+    bool bus_held_;
+    size_t held_bytes_;
+
+    // 所有阻塞式传输的唯一出口, 负责记录统计与跟踪
+    bool Transmit(spi_transaction_t* t);
+
+    // --- 队列传输 (spi_device_queue_trans) ---
+    struct QueueSlot
+    {
+        spi_transaction_t trans;
+        SpiDevice* owner;
+        uint8_t* buffer;  // InitQueue 预分配的 DMA 缓冲, 零拷贝提交时不使用
+        SpiQueueCallback callback;
+        void* arg;
+        bool free;
+    };
+
+    QueueSlot slots_[kMaxQueueSlots];
+    size_t slot_count_;
+    size_t chunk_size_;
+    size_t in_flight_;
+    int queue_size_;
+    TaskHandle_t queue_notify_;
+
+    int AcquireSlot(int timeout_ms);
+    bool SubmitSlot(int slot, const uint8_t* tx, uint8_t* rx, size_t len);
+    bool ReclaimOne(int timeout_ms);
+    static void OnPostTrans(spi_transaction_t* t);
+
+    // 寄存器地址走 address phase, 数据直接使用调用方缓冲区; <= 4 字节时使用事务内联缓冲
+    bool RegTransfer(uint8_t reg_addr, const uint8_t* tx_data, uint8_t* rx_data, size_t len);
 
    public:
     SpiDevice(Logger& logger);
@@ -118,7 +257,7 @@ class SpiDevice
         t.length = len * 8;
         t.tx_buffer = tx_data;
         t.rx_buffer = rx_data;
-        return spi_device_transmit(dev_handle_, &t) == ESP_OK;
+        return Transmit(&t);
     }
 
     inline bool Write(const uint8_t* data, size_t len)
@@ -127,7 +266,7 @@ class SpiDevice
         t.length = len * 8;
         t.tx_buffer = data;
         t.rx_buffer = nullptr;
-        return spi_device_transmit(dev_handle_, &t) == ESP_OK;
+        return Transmit(&t);
     }
 
     inline bool Read(uint8_t* rx_data, size_t len)
@@ -136,9 +275,27 @@ class SpiDevice
         t.length = len * 8;
         t.tx_buffer = nullptr;
         t.rx_buffer = rx_data;
-        return spi_device_transmit(dev_handle_, &t) == ESP_OK;
+        return Transmit(&t);
+    }
+
+    // --- span variants (no heap allocation) ---
+
+    inline bool Transfer(std::span<const uint8_t> tx_data, std::span<uint8_t> rx_data)
+    {
+        if (rx_data.size() > tx_data.size())
+            return false;
+        spi_transaction_t t = {};
+        t.length = tx_data.size() * 8;
+        t.rxlength = rx_data.size() * 8;
+        t.tx_buffer = tx_data.data();
+        t.rx_buffer = rx_data.data();
+        return Transmit(&t);
     }
 
+    inline bool Write(std::span<const uint8_t> data) { return Write(data.data(), data.size()); }
+
+    inline bool Read(std::span<uint8_t> rx_data) { return Read(rx_data.data(), rx_data.size()); }
+
     // --- vector variants ---
 
     bool Transfer(const std::vector<uint8_t>& tx_data, std::vector<uint8_t>& rx_data);
@@ -153,6 +310,8 @@ class SpiDevice
     // --- register operations ---
     bool WriteRegBytes(uint8_t reg_addr, const std::vector<uint8_t>& data);
     bool ReadRegBytes(uint8_t reg_addr, std::vector<uint8_t>& data, size_t len);
+    bool WriteRegBytes(uint8_t reg_addr, std::span<const uint8_t> data);
+    bool ReadRegBytes(uint8_t reg_addr, std::span<uint8_t> data);
 
     bool WriteReg8(uint8_t reg_addr, uint8_t data);
     bool ReadReg8(uint8_t reg_addr, uint8_t& data);
@@ -165,6 +324,98 @@ class SpiDevice
     bool ReadRegBit(uint8_t reg_addr, uint8_t bit, bool& value);
     bool WriteRegBits(uint8_t reg_addr, uint8_t mask, uint8_t value);
     bool ReadRegBits(uint8_t reg_addr, uint8_t mask, uint8_t& value);
+
+    // --- register cache (see I2cDevice) ---
+    void CacheRegisters(uint8_t first_reg, uint8_t last_reg);
+    void MarkVolatile(uint8_t first_reg, uint8_t last_reg);
+    void InvalidateCache();
+    void InvalidateCache(uint8_t first_reg, uint8_t last_reg);
+    bool RefreshCache();
+
+    // --- register format / low-latency path ---
+    void SetRegFormat(const SpiRegFormat& format) { reg_format_ = format; }
+    const SpiRegFormat& GetRegFormat() const { return reg_format_; }
+    // 数据段不超过 max_bytes 的传输走 spi_device_polling_transmit, 省去中断与任务切换; 0 关闭
+    void SetPollingThreshold(size_t max_bytes) { polling_max_bytes_ = max_bytes; }
+
+    // 独占总线: 期间本设备的连续传输不再逐次仲裁, 其它设备的传输被挂起.
+    // timeout_ms 只限制等待仲裁器的时间; 驱动锁 (spi_device_acquire_bus) 总是无限等待
+    bool AcquireBus(int timeout_ms);
+    void ReleaseBus();
+
+    // 在一次 CS 有效期内执行整个序列, 期间独占总线 (已在 AcquireBus 区间内时沿用该区间).
+    // 任一段失败即中止, 并以空事务撤销片选. timeout_ms 的含义同 AcquireBus
+    bool Execute(SpiSequence& sequence, int timeout_ms = -1);
+
+    // 接入共享总线仲裁: 每次阻塞传输 (或 AcquireBus 区间) 占用一个仲裁时间片.
+    // 队列传输不经过仲裁, 由调用方自行用 AcquireBus 包围
+    void SetArbiter(SpiArbiter& arbiter, int client)
+    {
+        arbiter_ = &arbiter;
+        arbiter_client_ = client;
+    }
+
+    // --- queued transfers ---
+    // 预分配 depth 块 chunk_size 字节的 DMA 缓冲; depth 不超过 kMaxQueueSlots 与设备 queue_size.
+    // 队列接口仅供单个任务使用; 阻塞式接口调用前会先等待所有队列传输完成.
+    // 完成通知依赖设备的 post_cb, 若 SpiDeviceConfig 自带 post_cb 则回调与任务通知不可用.
+    bool InitQueue(size_t depth, size_t chunk_size);
+    void DeinitQueue();
+    size_t GetChunkSize() const { return chunk_size_; }
+    size_t GetInFlight() const { return in_flight_; }
+    void SetQueueNotify(TaskHandle_t task) { queue_notify_ = task; }
+
+    bool AcquireChunk(SpiChunk& chunk, int timeout_ms);
+    bool QueueChunk(SpiChunk& chunk,
+                    size_t len,
+                    SpiQueueCallback callback = nullptr,
+                    void* arg = nullptr);
+    // 零拷贝: 调用方缓冲区须为 DMA 可访问内存, 并在完成前保持有效
+    bool QueueTransfer(const uint8_t* tx_data,
+                       uint8_t* rx_data,
+                       size_t len,
+                       int timeout_ms,
+                       SpiQueueCallback callback = nullptr,
+                       void* arg = nullptr);
+    // 分块拷贝到缓冲池并连续提交, CPU 拷贝下一块时上一块正在传输
+    bool QueueWrite(const uint8_t* data, size_t len, int timeout_ms);
+    // 回收已完成的传输; FlushQueue 等待全部完成
+    size_t ReclaimQueued();
+    bool FlushQueue(int timeout_ms);
+
+    // --- statistics (CONFIG_WRAPPER_ESP32_BUS_STATS) ---
+    BusStatsSnapshot GetStats() const { return stats_.Snapshot(); }
+    void ResetStats() { stats_.Reset(); }
+};
+
+/**
+ * @brief 作用域总线独占 (spi_device_acquire_bus)
+ *
+ *     SpiBusGuard guard(dev);
+ *     if (guard.Acquired()) { dev.WriteReg8(...); dev.ReadReg8(...); }
+ *
+ * 设备接入 SpiArbiter 时可给出 timeout_ms, 仅限制等待仲裁的时间.
+ */
+class SpiBusGuard
+{
+    SpiDevice& device_;
+    bool acquired_;
+
+   public:
+    SpiBusGuard(SpiDevice& device, int timeout_ms = -1)
+        : device_(device), acquired_(device.AcquireBus(timeout_ms))
+    {
+    }
+    ~SpiBusGuard()
+    {
+        if (acquired_)
+            device_.ReleaseBus();
+    }
+
+    SpiBusGuard(const SpiBusGuard&) = delete;
+    SpiBusGuard& operator=(const SpiBusGuard&) = delete;
+
+    bool Acquired() const { return acquired_; }
 };
 
 }  // namespace wrapper
\ No newline at end of file
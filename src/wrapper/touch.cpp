@@ -134,3 +134,19 @@ bool I2cTouch::GetCoordinates(
 
     return (cnt > 0);
 }
+
+bool I2cTouch::SetOrientation(bool swap_xy, bool mirror_x, bool mirror_y)
+{
+    if (touch_handle_ == NULL)
+    {
+        return false;
+    }
+    if (esp_lcd_touch_set_swap_xy(touch_handle_, swap_xy) != ESP_OK ||
+        esp_lcd_touch_set_mirror_x(touch_handle_, mirror_x) != ESP_OK ||
+        esp_lcd_touch_set_mirror_y(touch_handle_, mirror_y) != ESP_OK)
+    {
+        logger_.Error("Failed to set touch orientation");
+        return false;
+    }
+    return true;
+}
@@ -94,6 +94,10 @@ class I2cTouch
     bool GetData(esp_lcd_touch_point_data_t* data, uint8_t* point_cnt, uint8_t max_point_cnt);
     bool GetCoordinates(
         uint16_t* x, uint16_t* y, uint16_t* strength, uint8_t* point_num, uint8_t max_point_num);
+
+    // 运行时修改坐标变换, 与显示的软件旋转 (DisplayBase::EnableSoftwareRotation) 保持一致.
+    // 经 LVGL 输入设备读取时由 LVGL 按显示旋转处理, 无需调用
+    bool SetOrientation(bool swap_xy, bool mirror_x, bool mirror_y);
 };
 
 }  // namespace wrapper
@@ -1,6 +1,7 @@
 #pragma once
 #include <cstring>
 #include <initializer_list>
+#include <span>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -87,6 +88,13 @@ class UartDevice
 
     inline int WriteByte(uint8_t data) { return uart_write_bytes(port_->GetPort(), &data, 1); }
 
+    // --- write: span (no heap allocation) ---
+
+    inline int WriteBytes(std::span<const uint8_t> data)
+    {
+        return uart_write_bytes(port_->GetPort(), data.data(), data.size());
+    }
+
     // --- write: vector / string ---
 
     int WriteBytes(const std::vector<uint8_t>& data);
@@ -110,6 +118,11 @@ class UartDevice
         return uart_read_bytes(port_->GetPort(), buf, len, pdMS_TO_TICKS(timeout_ms));
     }
 
+    inline int ReadBytes(std::span<uint8_t> buf, int timeout_ms)
+    {
+        return uart_read_bytes(port_->GetPort(), buf.data(), buf.size(), pdMS_TO_TICKS(timeout_ms));
+    }
+
     // --- read: single byte / vector ---
 
     int ReadByte(uint8_t& data, int timeout_ms);